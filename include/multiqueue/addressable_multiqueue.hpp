@@ -0,0 +1,301 @@
+/**
+******************************************************************************
+* @file:   addressable_multiqueue.hpp
+*
+* @brief:  Multiqueue whose elements can be located to decrease their key or erase them
+*******************************************************************************
+**/
+#pragma once
+#ifndef ADDRESSABLE_MULTIQUEUE_HPP_INCLUDED
+#define ADDRESSABLE_MULTIQUEUE_HPP_INCLUDED
+
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/sequential/heap/addressable_heap.hpp"
+#include "multiqueue/util/backoff.hpp"
+#include "system_config.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace multiqueue {
+
+// Elements are represented by locators owned by the user. A locator is contained in at most one local queue at a
+// time and must not be moved or destroyed while contained. Buffering, the merge heap, stickiness and pheromones of
+// the configuration are not supported, as elements have to stay addressable inside the heap.
+template <typename Key, typename T, typename Comparator = std::less<Key>,
+          typename Configuration = configuration::Default, typename Allocator = std::allocator<Key>>
+class addressable_multiqueue
+    : private multiqueue_base<Key, T, Comparator, typename Configuration::RandomEngine> {
+   private:
+    using base_type = multiqueue_base<Key, T, Comparator, typename Configuration::RandomEngine>;
+
+   public:
+    using allocator_type = Allocator;
+    using key_type = typename base_type::key_type;
+    using mapped_type = typename base_type::mapped_type;
+    using value_type = typename base_type::value_type;
+    using key_comparator = typename base_type::key_comparator;
+    using size_type = typename base_type::size_type;
+    struct Handle {
+        friend class addressable_multiqueue;
+
+       private:
+        uint32_t id_;
+
+       private:
+        explicit Handle(unsigned int id) noexcept : id_{static_cast<uint32_t>(id)} {
+        }
+    };
+
+   private:
+    using heap_type = sequential::addressable_heap<
+        key_type, mapped_type, key_comparator, Configuration::HeapDegree,
+        typename std::allocator_traits<typename Configuration::HeapAllocator>::template rebind_alloc<
+            sequential::addressable_node<key_type, mapped_type> *>>;
+
+    // Marks a locator that is not contained in any queue
+    static constexpr std::uint32_t no_queue = std::numeric_limits<std::uint32_t>::max();
+    // Marks a locator that is about to be pushed by some thread
+    static constexpr std::uint32_t pushing = no_queue - 1;
+
+   public:
+    class locator : private sequential::addressable_node<key_type, mapped_type> {
+        friend class addressable_multiqueue;
+        using node_type = sequential::addressable_node<key_type, mapped_type>;
+
+        // Only changed while holding the lock of the queue the locator is (or will be) contained in, except for
+        // claiming an uncontained locator
+        std::atomic_uint32_t queue_index_{no_queue};
+
+       public:
+        locator() = default;
+
+        // The key and value may only be read while no other thread modifies the locator
+        using node_type::key;
+        using node_type::value;
+
+        inline bool contained() const noexcept {
+            return queue_index_.load(std::memory_order_acquire) < pushing;
+        }
+    };
+
+   private:
+    struct alignas(2 * L1_CACHE_LINESIZE) InternalPriorityQueueWrapper {
+        using allocator_type = typename heap_type::allocator_type;
+        mutable std::atomic_uint32_t guard = 0;
+        heap_type heap;
+
+        InternalPriorityQueueWrapper() = default;
+
+        explicit InternalPriorityQueueWrapper(Comparator const &comp, allocator_type const &alloc = allocator_type())
+            : heap(comp, alloc) {
+        }
+
+        inline bool try_lock() const noexcept {
+            uint32_t expected = 0;
+            return guard.load(std::memory_order_relaxed) == 0 &&
+                guard.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        inline void unlock() const noexcept {
+            assert(guard == 1);
+            guard.store(0, std::memory_order_release);
+        }
+    };
+
+    using queue_alloc_type = typename allocator_type::template rebind<InternalPriorityQueueWrapper>::other;
+    using alloc_traits = std::allocator_traits<queue_alloc_type>;
+    using base_type::comp_;
+    using base_type::thread_data_;
+
+   private:
+    InternalPriorityQueueWrapper *pq_list_;
+    size_type pq_list_size_;
+    queue_alloc_type alloc_;
+
+   private:
+    // Locks the queue `loc` is contained in and returns its index, or returns false if `loc` is not contained
+    bool lock_owner(locator &loc, size_type &index) {
+        typename Configuration::Backoff backoff{};
+        while (true) {
+            auto const q = loc.queue_index_.load(std::memory_order_acquire);
+            if (q == no_queue) {
+                return false;
+            }
+            if (q != pushing && pq_list_[q].try_lock()) {
+                // The locator might have been extracted and pushed somewhere else in the meantime
+                if (loc.queue_index_.load(std::memory_order_relaxed) == q) {
+                    index = q;
+                    return true;
+                }
+                pq_list_[q].unlock();
+            }
+            backoff();
+        }
+    }
+
+    // `loc` must have been claimed by this thread
+    void push_claimed(Handle handle, locator &loc, key_type const &key, mapped_type const &value) {
+        size_type index = thread_data_[handle.id_].get_random_index();
+        typename Configuration::Backoff backoff{};
+        while (!pq_list_[index].try_lock()) {
+            backoff();
+            index = thread_data_[handle.id_].get_random_index();
+        }
+        pq_list_[index].heap.push(loc, key, value);
+        loc.queue_index_.store(static_cast<std::uint32_t>(index), std::memory_order_release);
+        pq_list_[index].unlock();
+    }
+
+    // Samples two local queues and keeps the one with the smaller top element locked. Returns false if both sampled
+    // queues are empty, in which case no queue remains locked.
+    bool lock_top_queue(Handle handle, size_type &index) {
+        size_type first_index;
+        size_type second_index;
+        thread_data_[handle.id_].get_random_indices(first_index, second_index);
+        typename Configuration::Backoff backoff{};
+
+        while (!pq_list_[first_index].try_lock()) {
+            backoff();
+            first_index = thread_data_[handle.id_].get_random_index();
+        }
+        bool first_empty = pq_list_[first_index].heap.empty();
+        if (first_empty) {
+            pq_list_[first_index].unlock();
+        }
+
+        while (!pq_list_[second_index].try_lock()) {
+            backoff();
+            second_index = thread_data_[handle.id_].get_random_index();
+        }
+        bool second_empty = pq_list_[second_index].heap.empty();
+        if (second_empty) {
+            pq_list_[second_index].unlock();
+        }
+
+        if (first_empty && second_empty) {
+            return false;
+        }
+
+        if (!first_empty && !second_empty) {
+            if (comp_(pq_list_[second_index].heap.top().key(), pq_list_[first_index].heap.top().key())) {
+                std::swap(first_index, second_index);
+            }
+            pq_list_[second_index].unlock();
+        } else if (first_empty) {
+            first_index = second_index;
+        }
+        index = first_index;
+        return true;
+    }
+
+   public:
+    explicit addressable_multiqueue(unsigned int const num_threads, std::uint32_t seed = 0,
+                                    allocator_type const &alloc = allocator_type())
+        : base_type{num_threads, Configuration::C, seed}, pq_list_size_{num_threads * Configuration::C}, alloc_(alloc) {
+        assert(num_threads >= 1);
+        pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
+        for (std::size_t i = 0; i < pq_list_size_; ++i) {
+            alloc_traits::construct(alloc_, pq_list_ + i);
+            pq_list_[i].heap.reserve(Configuration::ReservePerQueue);
+        }
+    }
+
+    ~addressable_multiqueue() noexcept {
+        for (size_type i = 0; i < pq_list_size_; ++i) {
+            alloc_traits::destroy(alloc_, pq_list_ + i);
+        }
+        alloc_traits::deallocate(alloc_, pq_list_, pq_list_size_);
+    }
+
+    static Handle get_handle(unsigned int id) noexcept {
+        return Handle{id};
+    }
+
+    // `loc` must not be contained in any queue and must not be accessed concurrently
+    void push(Handle handle, locator &loc, key_type const &key, mapped_type const &value) {
+        assert(!loc.contained());
+        loc.queue_index_.store(pushing, std::memory_order_relaxed);
+        push_claimed(handle, loc, key, value);
+    }
+
+    // Returns true if the key of `loc` was decreased and false if `loc` is not contained or `key` is not smaller
+    // than its current key
+    bool decrease_key(Handle, locator &loc, key_type const &key) {
+        size_type index;
+        if (!lock_owner(loc, index)) {
+            return false;
+        }
+        bool const decreased = pq_list_[index].heap.decrease_key(loc, key);
+        pq_list_[index].unlock();
+        return decreased;
+    }
+
+    // Pushes `loc` if it is not contained and otherwise decreases its key, which is safe to call concurrently with
+    // all other operations on the same locator. Returns true if `loc` was pushed.
+    bool push_or_decrease_key(Handle handle, locator &loc, key_type const &key, mapped_type const &value) {
+        typename Configuration::Backoff backoff{};
+        while (true) {
+            auto q = no_queue;
+            if (loc.queue_index_.compare_exchange_strong(q, pushing, std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+                push_claimed(handle, loc, key, value);
+                return true;
+            }
+            size_type index;
+            if (q != pushing && lock_owner(loc, index)) {
+                pq_list_[index].heap.decrease_key(loc, key);
+                pq_list_[index].unlock();
+                return false;
+            }
+            backoff();
+        }
+    }
+
+    // Returns false if `loc` is not contained
+    bool erase(Handle, locator &loc) {
+        size_type index;
+        if (!lock_owner(loc, index)) {
+            return false;
+        }
+        pq_list_[index].heap.erase(loc);
+        loc.queue_index_.store(no_queue, std::memory_order_release);
+        pq_list_[index].unlock();
+        return true;
+    }
+
+    bool extract_top(Handle handle, value_type &retval) {
+        size_type index;
+        if (!lock_top_queue(handle, index)) {
+            return false;
+        }
+        auto &loc = static_cast<locator &>(pq_list_[index].heap.top());
+        pq_list_[index].heap.extract_top(retval);
+        loc.queue_index_.store(no_queue, std::memory_order_release);
+        pq_list_[index].unlock();
+        return true;
+    }
+
+    static std::string description() {
+        std::stringstream ss;
+        ss << "addressable multiqueue\n\t";
+        ss << "C: " << Configuration::C << "\n\t";
+        ss << "Heap degree: " << Configuration::HeapDegree << "\n\t";
+        ss << "Preallocation for " << Configuration::ReservePerQueue << " elements per internal pq";
+        return ss.str();
+    }
+};
+
+}  // namespace multiqueue
+
+#endif  //! ADDRESSABLE_MULTIQUEUE_HPP_INCLUDED
@@ -14,8 +14,10 @@
 #include "multiqueue/sequential/heap/full_down_strategy.hpp"
 #include "multiqueue/sequential/heap/heap.hpp"
 #include "multiqueue/sequential/heap/merge_heap.hpp"
+#include "multiqueue/util/backoff.hpp"
 #include "multiqueue/util/buffer.hpp"
 #include "multiqueue/util/extractors.hpp"
+#include "multiqueue/util/random.hpp"
 #include "multiqueue/util/ring_buffer.hpp"
 #include "sequential/heap/heap.hpp"
 
@@ -30,26 +32,75 @@ struct Default {
     static constexpr unsigned int C = 4;
     // Stickiness of selected queue
     static constexpr unsigned int K = 1;
+    // Number of local queues sampled per extraction, of which the one with the smallest top key is used. Larger
+    // values lower the rank error at the cost of more cache misses per extraction (with K == 1 only, the generic
+    // multiqueue compares more than two queues only with top snapshots).
+    static constexpr unsigned int ExtractSampleSize = 2;
+    // Number of local queues sampled per insertion, of which an unlocked one with the largest top key (the least loaded
+    // in expectation) is used
+    static constexpr unsigned int InsertSampleSize = 1;
     // Activate/Deactivate deletion and insertion buffer (only with merge heap deactivated)
     static constexpr bool WithDeletionBuffer = true;
     static constexpr bool WithInsertionBuffer = true;
     // Buffer sizes (number of elements)
     static constexpr std::size_t DeletionBufferSize = 8;
     static constexpr std::size_t InsertionBufferSize = 8;
+    // Number of pushes a handle collects without synchronization before moving them into a local queue (0 disables
+    // staging, only used by the generic multiqueue). At most this many elements per handle are invisible to other
+    // handles, which bounds the additional rank error.
+    static constexpr std::size_t StagingBufferSize = 0;
+    // Number of minima a handle moves from a won queue into a private cache, from which it extracts until a sampled
+    // queue has a smaller top key (0 disables the cache, only used by the int multiqueue). Extractions with the cache
+    // always sample fresh queues and never delegate, so it requires `K == 1` without `AdaptiveK` and `UseCombining`.
+    static constexpr std::size_t DeletionCacheSize = 0;
+    // Fraction of keys whose extractions are measured to estimate rank error and delay online (0 disables the
+    // measurement, only used by the int multiqueue)
+    static constexpr double QualitySampleRate = 0.0;
+    // Count lock failures, retries, empty extractions and work done inside the local queues per handle (only used by
+    // the int multiqueue). Disabled, the counters compile to nothing.
+    static constexpr bool CollectStats = false;
     // Use a merging heap (implies using buffers with sizes dependent on the node size)
     static constexpr bool UseMergeHeap = false;
     // Node size used only by the merge heap
     static constexpr std::size_t NodeSize = 128;
     // Use pheromones on the locks
     static constexpr bool WithPheromones = false;
+    // Publish the top key of each queue via a seqlock, so that sampled queues can be compared without locking them
+    // (only the generic multiqueue with trivially copyable keys)
+    static constexpr bool WithTopSnapshot = true;
     // Make multiqueue numa friendly (induces more overhead)
     static constexpr bool NumaFriendly = false;
+    // Probability that a handle bound to a numa node samples from all queues instead of the queues on its node
+    static constexpr double NumaRemoteProbability = 0.1;
     // degree of the heap tree (effect only if merge heap deactivated)
     static constexpr unsigned int HeapDegree = 8;
-    // Number of elements to preallocate in each queue
-    static constexpr std::size_t ReservePerQueue = 1'000'000;
+    // Number of elements per block of heap storage, a power of two. Growing a blocked heap allocates one block and
+    // never moves existing elements, so a push under the lock never pays for a reallocation (0 stores each heap in
+    // one contiguous vector).
+    static constexpr std::size_t HeapBlockSize = 0;
+    // Number of elements to preallocate in each queue. Queues grow geometrically beyond it on demand, and a larger
+    // total can be reserved with `reserve` once the expected size is known. Without numa friendliness, only address
+    // space is reserved up front and its pages are populated by the threads pushing into the queue.
+    static constexpr std::size_t ReservePerQueue = 1 << 10;
     using HeapAllocator = std::allocator<int>;
     using SiftStrategy = sequential::sift_strategy::FullDown;
+    // Random engine used by each handle to sample queue indices
+    using RandomEngine = util::xoshiro256starstar;
+    // Waiting policy between failed attempts to lock a queue
+    using Backoff = util::backoff::None;
+    // Number of failed extractions before a waiting extraction parks the thread
+    static constexpr unsigned int WaitSpins = 64;
+    // Adapt the stickiness of each handle at runtime within [MinK, MaxK], starting with K. After every period of
+    // `stickiness` operations, it is halved if a sticky queue was contended or empty during the period and doubled
+    // otherwise.
+    static constexpr bool AdaptiveK = false;
+    static constexpr unsigned int MinK = 1;
+    static constexpr unsigned int MaxK = 64;
+    // Let threads delegate operations on a contended queue to its lock holder instead of retrying elsewhere (only
+    // used by the int_multiqueue with K == 1)
+    static constexpr bool UseCombining = false;
+    // Number of publication slots per queue for delegated operations
+    static constexpr std::size_t CombiningSlots = 4;
 };
 
 struct NoBuffering : Default {
@@ -76,6 +127,27 @@ struct Merging : Default {
     static constexpr bool UseMergeHeap = true;
 };
 
+struct Combining : Default {
+    static constexpr bool UseCombining = true;
+};
+
+struct AdaptiveStickiness : Default {
+    static constexpr bool AdaptiveK = true;
+    static constexpr unsigned int K = 4;
+};
+
+struct Staging : Default {
+    static constexpr std::size_t StagingBufferSize = 16;
+};
+
+struct DeletionCache : Default {
+    static constexpr std::size_t DeletionCacheSize = 8;
+};
+
+struct Segmented : Default {
+    static constexpr std::size_t HeapBlockSize = 4096;
+};
+
 }  // namespace configuration
 
 template <bool isMerging, bool WithInsertionBuffer, bool WithDeletionBuffer, typename Key, typename T,
@@ -86,7 +158,7 @@ template <typename Key, typename T, typename Comparator, typename Configuration>
 struct PriorityQueueConfiguration<false, false, false, Key, T, Comparator, Configuration> {
     using heap_type =
         sequential::key_value_heap<Key, T, Comparator, Configuration::HeapDegree, typename Configuration::SiftStrategy,
-                                   typename Configuration::HeapAllocator>;
+                                   typename Configuration::HeapAllocator, Configuration::HeapBlockSize>;
     using allocator_type = typename Configuration::HeapAllocator;
 
     heap_type heap;
@@ -115,10 +187,26 @@ struct PriorityQueueConfiguration<false, false, false, Key, T, Comparator, Confi
         heap.insert(value);
     }
 
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            heap.insert(*first);
+        }
+    }
+
     inline void pop() {
         heap.pop();
     }
 
+    // Writes the smallest key to `key` without restructuring the queue and returns false if the queue is empty
+    inline bool peek_top_key(Key &key) const {
+        if (heap.empty()) {
+            return false;
+        }
+        key = heap.top().first;
+        return true;
+    }
+
     inline bool empty() const noexcept {
         return heap.empty();
     }
@@ -132,7 +220,7 @@ template <typename Key, typename T, typename Comparator, typename Configuration>
 struct PriorityQueueConfiguration<false, true, false, Key, T, Comparator, Configuration> {
     using heap_type =
         sequential::key_value_heap<Key, T, Comparator, Configuration::HeapDegree, typename Configuration::SiftStrategy,
-                                   typename Configuration::HeapAllocator>;
+                                   typename Configuration::HeapAllocator, Configuration::HeapBlockSize>;
     using allocator_type = typename Configuration::HeapAllocator;
 
     util::buffer<typename heap_type::value_type, Configuration::InsertionBufferSize> insertion_buffer;
@@ -174,11 +262,34 @@ struct PriorityQueueConfiguration<false, true, false, Key, T, Comparator, Config
         }
     }
 
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
     inline void pop() {
         assert(insertion_buffer.empty());
         heap.pop();
     }
 
+    // Writes the smallest key to `key` without restructuring the queue and returns false if the queue is empty
+    inline bool peek_top_key(Key &key) const {
+        bool found = false;
+        for (auto const &v : insertion_buffer) {
+            if (!found || heap.get_comparator()(v.first, key)) {
+                key = v.first;
+                found = true;
+            }
+        }
+        if (!heap.empty() && (!found || heap.get_comparator()(heap.top().first, key))) {
+            key = heap.top().first;
+            found = true;
+        }
+        return found;
+    }
+
     inline bool empty() const noexcept {
         return insertion_buffer.empty() && heap.empty();
     }
@@ -192,7 +303,7 @@ template <typename Key, typename T, typename Comparator, typename Configuration>
 struct PriorityQueueConfiguration<false, false, true, Key, T, Comparator, Configuration> {
     using heap_type =
         sequential::key_value_heap<Key, T, Comparator, Configuration::HeapDegree, typename Configuration::SiftStrategy,
-                                   typename Configuration::HeapAllocator>;
+                                   typename Configuration::HeapAllocator, Configuration::HeapBlockSize>;
     using allocator_type = typename Configuration::HeapAllocator;
 
     util::ring_buffer<typename heap_type::value_type, Configuration::DeletionBufferSize> deletion_buffer;
@@ -245,11 +356,31 @@ struct PriorityQueueConfiguration<false, false, true, Key, T, Comparator, Config
         }
     }
 
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
     inline void pop() {
         assert(!deletion_buffer.empty());
         deletion_buffer.pop_front();
     }
 
+    // Writes the smallest key to `key` without restructuring the queue and returns false if the queue is empty
+    inline bool peek_top_key(Key &key) const {
+        if (!deletion_buffer.empty()) {
+            key = deletion_buffer.front().first;
+            return true;
+        }
+        if (heap.empty()) {
+            return false;
+        }
+        key = heap.top().first;
+        return true;
+    }
+
     inline bool empty() const noexcept {
         return deletion_buffer.empty() && heap.empty();
     }
@@ -263,13 +394,22 @@ template <typename Key, typename T, typename Comparator, typename Configuration>
 struct PriorityQueueConfiguration<false, true, true, Key, T, Comparator, Configuration> {
     using heap_type =
         sequential::key_value_heap<Key, T, Comparator, Configuration::HeapDegree, typename Configuration::SiftStrategy,
-                                   typename Configuration::HeapAllocator>;
+                                   typename Configuration::HeapAllocator, Configuration::HeapBlockSize>;
     using allocator_type = typename Configuration::HeapAllocator;
     util::buffer<typename heap_type::value_type, Configuration::InsertionBufferSize> insertion_buffer;
     util::ring_buffer<typename heap_type::value_type, Configuration::DeletionBufferSize> deletion_buffer;
 
     heap_type heap;
 
+    PriorityQueueConfiguration() = default;
+
+    explicit PriorityQueueConfiguration(allocator_type const &alloc) : heap(alloc) {
+    }
+
+    explicit PriorityQueueConfiguration(Comparator const &comp, allocator_type const &alloc = allocator_type())
+        : heap(comp, alloc) {
+    }
+
     inline typename heap_type::value_type const &top() {
         assert(!deletion_buffer.empty());
         return deletion_buffer.front();
@@ -327,11 +467,39 @@ struct PriorityQueueConfiguration<false, true, true, Key, T, Comparator, Configu
         }
     }
 
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
     void pop() {
         assert(!deletion_buffer.empty());
         deletion_buffer.pop_front();
     }
 
+    // Writes the smallest key to `key` without restructuring the queue and returns false if the queue is empty
+    inline bool peek_top_key(Key &key) const {
+        // Elements smaller than the back of the deletion buffer are always put into the deletion buffer
+        if (!deletion_buffer.empty()) {
+            key = deletion_buffer.front().first;
+            return true;
+        }
+        bool found = false;
+        for (auto const &v : insertion_buffer) {
+            if (!found || heap.get_comparator()(v.first, key)) {
+                key = v.first;
+                found = true;
+            }
+        }
+        if (!heap.empty() && (!found || heap.get_comparator()(heap.top().first, key))) {
+            key = heap.top().first;
+            found = true;
+        }
+        return found;
+    }
+
     inline bool empty() const noexcept {
         return insertion_buffer.empty() && deletion_buffer.empty() && heap.empty();
     }
@@ -343,8 +511,10 @@ struct PriorityQueueConfiguration<false, true, true, Key, T, Comparator, Configu
 
 template <typename Key, typename T, typename Comparator, typename Configuration>
 struct PriorityQueueConfiguration<true, true, true, Key, T, Comparator, Configuration> {
-    using heap_type = sequential::key_value_merge_heap<Key, T, Comparator, Configuration::NodeSize,
-                                                       typename Configuration::HeapAllocator>;
+    // The block size of the merge heap is given in nodes
+    using heap_type = sequential::key_value_merge_heap<
+        Key, T, Comparator, Configuration::NodeSize, typename Configuration::HeapAllocator,
+        (Configuration::HeapBlockSize + Configuration::NodeSize - 1) / Configuration::NodeSize>;
     using allocator_type = typename Configuration::HeapAllocator;
 
     util::buffer<typename heap_type::value_type, Configuration::NodeSize> insertion_buffer;
@@ -389,7 +559,7 @@ struct PriorityQueueConfiguration<true, true, true, Key, T, Comparator, Configur
                     return heap.get_comparator()(heap.top_node().back().first, v.first);
                 });
                 std::sort(insert_it, insertion_buffer.end(), [&](auto const &lhs, auto const &rhs) {
-                    return heap.get_comparator()(rhs.first, lhs.first);
+                    return heap.get_comparator()(lhs.first, rhs.first);
                 });
                 auto heap_it = heap.top_node().begin();
                 for (auto current = insert_it; current != insertion_buffer.end(); ++current) {
@@ -440,11 +610,57 @@ struct PriorityQueueConfiguration<true, true, true, Key, T, Comparator, Configur
         insertion_buffer.push_back(value);
     }
 
+    // Elements that do not belong into the deletion buffer are collected in full nodes, which are sorted and inserted
+    // into the heap directly. Only the remainder takes the way through the insertion buffer.
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        typename heap_type::node_type node;
+        std::size_t node_fill = 0;
+        for (; first != last; ++first) {
+            if (!deletion_buffer.empty() && heap.get_comparator()(first->first, deletion_buffer.back().first)) {
+                push(*first);
+                continue;
+            }
+            node[node_fill++] = *first;
+            if (node_fill == Configuration::NodeSize) {
+                std::sort(node.begin(), node.end(), [&](auto const &lhs, auto const &rhs) {
+                    return heap.get_comparator()(lhs.first, rhs.first);
+                });
+                heap.insert(node.begin(), node.end());
+                node_fill = 0;
+            }
+        }
+        for (std::size_t i = 0; i < node_fill; ++i) {
+            push(node[i]);
+        }
+    }
+
     void pop() {
         assert(!deletion_buffer.empty());
         deletion_buffer.pop_front();
     }
 
+    // Writes the smallest key to `key` without restructuring the queue and returns false if the queue is empty
+    inline bool peek_top_key(Key &key) const {
+        // Elements smaller than the back of the deletion buffer are always put into the deletion buffer
+        if (!deletion_buffer.empty()) {
+            key = deletion_buffer.front().first;
+            return true;
+        }
+        bool found = false;
+        for (auto const &v : insertion_buffer) {
+            if (!found || heap.get_comparator()(v.first, key)) {
+                key = v.first;
+                found = true;
+            }
+        }
+        if (!heap.empty() && (!found || heap.get_comparator()(heap.top().first, key))) {
+            key = heap.top().first;
+            found = true;
+        }
+        return found;
+    }
+
     inline bool empty() const noexcept {
         return insertion_buffer.empty() && deletion_buffer.empty() && heap.empty();
     }
@@ -1,6 +1,6 @@
 /**
 ******************************************************************************
-* @file:   multiqueue.hpp
+* @file:   int_multiqueue.hpp
 *
 * @author: Marvin Williams
 * @date:   2021/03/29 17:19
@@ -8,14 +8,21 @@
 *******************************************************************************
 **/
 #pragma once
-#ifndef MULTIQUEUE_HPP_INCLUDED
-#define MULTIQUEUE_HPP_INCLUDED
+#ifndef INT_MULTIQUEUE_HPP_INCLUDED
+#define INT_MULTIQUEUE_HPP_INCLUDED
 
 #include "multiqueue/configurations.hpp"
 #include "multiqueue/sequential/heap/heap.hpp"
+#include "multiqueue/util/backoff.hpp"
 #include "multiqueue/util/buffer.hpp"
+#include "multiqueue/util/combining.hpp"
 #include "multiqueue/util/extractors.hpp"
+#include "multiqueue/util/numa.hpp"
+#include "multiqueue/util/parking.hpp"
+#include "multiqueue/util/quality.hpp"
+#include "multiqueue/util/random.hpp"
 #include "multiqueue/util/ring_buffer.hpp"
+#include "multiqueue/util/stats.hpp"
 #include "sequential/heap/heap.hpp"
 #include "system_config.hpp"
 
@@ -25,18 +32,22 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <random>
 #include <sstream>
 #include <type_traits>
+#include <vector>
 
 namespace multiqueue {
 
-template <typename Key, typename T>
+template <typename Key, typename T, typename RandomEngine>
 struct int_multiqueue_base {
     static_assert(std::is_unsigned_v<Key>, "Key must be unsigned integer");
     using key_type = Key;
@@ -55,17 +66,70 @@ struct int_multiqueue_base {
         }
     };
 
+    // Counters of the deletion cache, summed over all handles
+    struct deletion_cache_stats {
+        // Extractions served from the cache without locking
+        std::uint64_t served = 0;
+        // Locked extractions that refilled the cache
+        std::uint64_t refills = 0;
+        // A sampled queue had a smaller top key than the cached minimum
+        std::uint64_t beaten = 0;
+        // Cached elements moved back into a queue because the cache was beaten
+        std::uint64_t returned = 0;
+    };
+
    protected:
     struct alignas(2 * L1_CACHE_LINESIZE) ThreadData {
-        std::mt19937 gen;
-        std::uniform_int_distribution<size_type> dist;
+        util::index_sampler<RandomEngine> sampler;
         unsigned int insert_count = 0;
         std::array<unsigned int, 2> extract_count = {0, 0};
         size_type insert_index;
         std::array<size_type, 2> extract_index;
+        // Current stickiness if it is adapted at runtime, and the operations and sticky queue failures of the handle in
+        // the current period
+        unsigned int stickiness = 1;
+        unsigned int period_operations = 0;
+        unsigned int period_failures = 0;
+        // Odd while the handle is idle (see `try_terminate`), only written by the owning thread
+        std::atomic_uint64_t idle_epoch{0};
+        // Minima taken from a local queue, the next one to extract is at `cache_pos`
+        std::vector<value_type> cache;
+        size_type cache_pos = 0;
+        // Queue the cache was last refilled from
+        size_type cache_source = 0;
+        deletion_cache_stats cache_stats;
 
         inline size_type get_random_index() {
-            return dist(gen);
+            return sampler();
+        }
+
+        // Both indices come from a single draw
+        inline void get_random_indices(size_type &first, size_type &second) {
+            sampler(first, second);
+        }
+
+        template <std::size_t N>
+        inline void get_random_indices(std::array<size_type, N> &indices) {
+            for (std::size_t i = 0; i + 1 < N; i += 2) {
+                sampler(indices[i], indices[i + 1]);
+            }
+            if constexpr (N % 2 == 1) {
+                indices[N - 1] = sampler();
+            }
+        }
+
+        // Samples from [first, last) with probability 1 - `remote_probability` and from all queues otherwise
+        inline void set_local_range(size_type first, size_type last, double remote_probability) {
+            sampler.set_local_range(first, last, remote_probability);
+        }
+
+        // Must be called while holding the lock of the queue an element was extracted from, so that a termination
+        // sweep locking this queue afterwards observes the handle as busy
+        inline void mark_busy() noexcept {
+            auto const epoch = idle_epoch.load(std::memory_order_relaxed);
+            if (epoch % 2 == 1) {
+                idle_epoch.store(epoch + 1, std::memory_order_relaxed);
+            }
         }
     };
 
@@ -73,11 +137,10 @@ struct int_multiqueue_base {
 
     explicit int_multiqueue_base(unsigned int const num_threads, unsigned int const C, std::uint32_t seed) {
         thread_data_ = new ThreadData[num_threads]();
-        auto params = typename std::uniform_int_distribution<size_type>::param_type{0, num_threads * C - 1};
         for (std::size_t i = 0; i < num_threads; ++i) {
             std::seed_seq seq{seed + i};
-            thread_data_[i].gen.seed(seq);
-            thread_data_[i].dist.param(params);
+            thread_data_[i].sampler.seed(seq);
+            thread_data_[i].sampler.set_size(num_threads * C);
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
             if (reinterpret_cast<std::uintptr_t>(&thread_data_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
                 std::abort();
@@ -101,23 +164,33 @@ struct alignas(Configuration::NumaFriendly
     using allocator_type = typename Configuration::HeapAllocator;
     using heap_type =
         sequential::key_value_heap<Key, T, std::less<Key>, Configuration::HeapDegree,
-                                   typename Configuration::SiftStrategy, typename Configuration::HeapAllocator>;
+                                   typename Configuration::SiftStrategy, typename Configuration::HeapAllocator,
+                                   Configuration::HeapBlockSize>;
     static constexpr uint32_t lock_mask = static_cast<uint32_t>(1) << 31;
     static constexpr uint32_t pheromone_mask = lock_mask - 1;
     static constexpr Key max_key = std::numeric_limits<Key>::max();
 
     mutable std::atomic_uint32_t guard = Configuration::WithPheromones ? pheromone_mask : 0;
     std::atomic<Key> top_key;
+    util::queue_counters<Configuration::CollectStats> stats;
 
     heap_type heap;
 
     explicit LocalPriorityQueue(allocator_type const &alloc = allocator_type()) : top_key(max_key), heap(alloc) {
     }
 
+    inline void count_heap_pop() noexcept {
+        if constexpr (Configuration::CollectStats) {
+            stats.add(util::counter::heap_pops);
+            stats.add(util::counter::sift_levels, util::heap_levels<Configuration::HeapDegree>(heap.size()));
+        }
+    }
+
     bool extract_top(typename heap_type::value_type &retval) {
         if (heap.empty()) {
             return false;
         }
+        count_heap_pop();
         heap.extract_top(retval);
         if (heap.empty()) {
             top_key.store(max_key, std::memory_order_release);
@@ -127,6 +200,25 @@ struct alignas(Configuration::NumaFriendly
         return true;
     };
 
+    // Only publishes the new top key once after extracting up to `n` elements
+    template <typename OutputIt>
+    std::size_t extract_batch(OutputIt out, std::size_t n) {
+        std::size_t count = 0;
+        typename heap_type::value_type tmp;
+        for (; count < n && !heap.empty(); ++count) {
+            count_heap_pop();
+            heap.extract_top(tmp);
+            *out = std::move(tmp);
+            ++out;
+        }
+        if (heap.empty()) {
+            top_key.store(max_key, std::memory_order_release);
+        } else {
+            top_key.store(heap.top().first, std::memory_order_release);
+        }
+        return count;
+    }
+
     void push(typename heap_type::value_type const &value) {
         heap.insert(value);
         if (heap.top().first == value.first) {
@@ -134,6 +226,16 @@ struct alignas(Configuration::NumaFriendly
         }
     }
 
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            heap.insert(*first);
+        }
+        if (!heap.empty()) {
+            top_key.store(heap.top().first, std::memory_order_release);
+        }
+    }
+
     inline bool empty() const noexcept {
         return heap.empty();
     }
@@ -142,6 +244,10 @@ struct alignas(Configuration::NumaFriendly
         return heap.size();
     }
 
+    inline bool is_locked() const noexcept {
+        return (guard.load(std::memory_order_relaxed) >> 31) == 1;
+    }
+
     inline bool try_lock(uint32_t id, bool claiming) const noexcept {
         uint32_t lock_status = guard.load(std::memory_order_relaxed);
         if ((lock_status >> 31) == 1) {
@@ -167,7 +273,8 @@ struct alignas(Configuration::NumaFriendly
     using allocator_type = typename Configuration::HeapAllocator;
     using heap_type =
         sequential::key_value_heap<Key, T, std::less<Key>, Configuration::HeapDegree,
-                                   typename Configuration::SiftStrategy, typename Configuration::HeapAllocator>;
+                                   typename Configuration::SiftStrategy, typename Configuration::HeapAllocator,
+                                   Configuration::HeapBlockSize>;
     static constexpr uint32_t lock_mask = static_cast<uint32_t>(1) << 31;
     static constexpr uint32_t pheromone_mask = lock_mask - 1;
     static constexpr Key max_key = std::numeric_limits<Key>::max();
@@ -176,13 +283,25 @@ struct alignas(Configuration::NumaFriendly
     std::atomic<Key> top_key;
     util::buffer<typename heap_type::value_type, Configuration::InsertionBufferSize> insertion_buffer;
     util::ring_buffer<typename heap_type::value_type, Configuration::DeletionBufferSize> deletion_buffer;
+    util::queue_counters<Configuration::CollectStats> stats;
 
     heap_type heap;
 
     explicit LocalPriorityQueue(allocator_type const &alloc = allocator_type()) : top_key(max_key), heap(alloc) {
     }
 
+    inline void count_heap_pop() noexcept {
+        if constexpr (Configuration::CollectStats) {
+            stats.add(util::counter::heap_pops);
+            stats.add(util::counter::sift_levels, util::heap_levels<Configuration::HeapDegree>(heap.size()));
+        }
+    }
+
     inline void flush_insertion_buffer() {
+        if (insertion_buffer.empty()) {
+            return;
+        }
+        stats.add(util::counter::insertion_buffer_flushes);
         for (auto &v : insertion_buffer) {
             heap.insert(v);
         }
@@ -191,9 +310,11 @@ struct alignas(Configuration::NumaFriendly
 
     void refresh_top() {
         assert(deletion_buffer.empty());
+        stats.add(util::counter::deletion_buffer_refills);
         flush_insertion_buffer();
         typename heap_type::value_type tmp;
         for (std::size_t i = 0; i < Configuration::DeletionBufferSize && !heap.empty(); ++i) {
+            count_heap_pop();
             heap.extract_top(tmp);
             deletion_buffer.push_back(std::move(tmp));
         }
@@ -216,6 +337,26 @@ struct alignas(Configuration::NumaFriendly
         return true;
     };
 
+    // Only publishes the new top key once after extracting up to `n` elements
+    template <typename OutputIt>
+    std::size_t extract_batch(OutputIt out, std::size_t n) {
+        std::size_t count = 0;
+        for (; count < n && !deletion_buffer.empty(); ++count) {
+            *out = std::move(deletion_buffer.front());
+            ++out;
+            deletion_buffer.pop_front();
+            if (deletion_buffer.empty()) {
+                refresh_top();
+            }
+        }
+        if (deletion_buffer.empty()) {
+            top_key.store(max_key, std::memory_order_release);
+        } else {
+            top_key.store(deletion_buffer.front().first, std::memory_order_release);
+        }
+        return count;
+    }
+
     void push(typename heap_type::value_type const &value) {
         if (deletion_buffer.empty() || value.first < deletion_buffer.back().first) {
             if (deletion_buffer.full()) {
@@ -245,6 +386,13 @@ struct alignas(Configuration::NumaFriendly
         }
     }
 
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
     inline bool empty() const noexcept {
         return deletion_buffer.empty();
     }
@@ -253,6 +401,10 @@ struct alignas(Configuration::NumaFriendly
         return insertion_buffer.size() + deletion_buffer.size() + heap.size();
     }
 
+    inline bool is_locked() const noexcept {
+        return (guard.load(std::memory_order_relaxed) >> 31) == 1;
+    }
+
     inline bool try_lock(uint32_t id, bool claiming) const noexcept {
         uint32_t lock_status = guard.load(std::memory_order_relaxed);
         if ((lock_status >> 31) == 1) {
@@ -275,8 +427,10 @@ template <typename Key, typename T, typename Configuration>
 struct alignas(Configuration::NumaFriendly
                    ? PAGESIZE
                    : 2 * L1_CACHE_LINESIZE) LocalPriorityQueue<Key, T, Configuration, true, true> {
-    using heap_type = sequential::key_value_merge_heap<Key, T, std::less<Key>, Configuration::NodeSize,
-                                                       typename Configuration::HeapAllocator>;
+    // The block size of the merge heap is given in nodes
+    using heap_type = sequential::key_value_merge_heap<
+        Key, T, std::less<Key>, Configuration::NodeSize, typename Configuration::HeapAllocator,
+        (Configuration::HeapBlockSize + Configuration::NodeSize - 1) / Configuration::NodeSize>;
     using allocator_type = typename Configuration::HeapAllocator;
 
     static constexpr uint32_t lock_mask = static_cast<uint32_t>(1) << 31;
@@ -287,13 +441,15 @@ struct alignas(Configuration::NumaFriendly
     std::atomic<Key> top_key;
     alignas(L1_CACHE_LINESIZE) util::buffer<typename heap_type::value_type, Configuration::NodeSize> insertion_buffer;
     util::ring_buffer<typename heap_type::value_type, Configuration::NodeSize * 2> deletion_buffer;
+    util::queue_counters<Configuration::CollectStats> stats;
     heap_type heap;
 
-    explicit LocalPriorityQueue(allocator_type const &alloc = allocator_type()) : heap(alloc) {
+    explicit LocalPriorityQueue(allocator_type const &alloc = allocator_type()) : top_key(max_key), heap(alloc) {
     }
 
     inline void flush_insertion_buffer() {
         assert(insertion_buffer.full());
+        stats.add(util::counter::insertion_buffer_flushes);
         std::sort(insertion_buffer.begin(), insertion_buffer.end(),
                   [&](auto const &lhs, auto const &rhs) { return lhs.first < rhs.first; });
         for (std::size_t i = 0; i < insertion_buffer.size(); i += Configuration::NodeSize) {
@@ -305,6 +461,7 @@ struct alignas(Configuration::NumaFriendly
 
     void refresh_top() {
         assert(deletion_buffer.empty());
+        stats.add(util::counter::deletion_buffer_refills);
         if (insertion_buffer.full()) {
             flush_insertion_buffer();
         }
@@ -313,7 +470,7 @@ struct alignas(Configuration::NumaFriendly
                 auto insert_it = std::partition(insertion_buffer.begin(), insertion_buffer.end(),
                                                 [&](auto const &v) { return heap.top_node().back().first < v.first; });
                 std::sort(insert_it, insertion_buffer.end(),
-                          [&](auto const &lhs, auto const &rhs) { return rhs.first < lhs.first; });
+                          [&](auto const &lhs, auto const &rhs) { return lhs.first < rhs.first; });
                 auto heap_it = heap.top_node().begin();
                 for (auto current = insert_it; current != insertion_buffer.end(); ++current) {
                     while (heap_it->first < current->first) {
@@ -326,6 +483,7 @@ struct alignas(Configuration::NumaFriendly
             } else {
                 std::move(heap.top_node().begin(), heap.top_node().end(), std::back_inserter(deletion_buffer));
             }
+            stats.add(util::counter::merge_node_pops);
             heap.pop_node();
         } else if (!insertion_buffer.empty()) {
             std::sort(insertion_buffer.begin(), insertion_buffer.end(),
@@ -352,6 +510,26 @@ struct alignas(Configuration::NumaFriendly
         return true;
     };
 
+    // Only publishes the new top key once after extracting up to `n` elements
+    template <typename OutputIt>
+    std::size_t extract_batch(OutputIt out, std::size_t n) {
+        std::size_t count = 0;
+        for (; count < n && !deletion_buffer.empty(); ++count) {
+            *out = std::move(deletion_buffer.front());
+            ++out;
+            deletion_buffer.pop_front();
+            if (deletion_buffer.empty()) {
+                refresh_top();
+            }
+        }
+        if (deletion_buffer.empty()) {
+            top_key.store(max_key, std::memory_order_release);
+        } else {
+            top_key.store(deletion_buffer.front().first, std::memory_order_release);
+        }
+        return count;
+    }
+
     void push(typename heap_type::value_type const &value) {
         if (deletion_buffer.empty() || value.first < deletion_buffer.back().first) {
             if (deletion_buffer.full()) {
@@ -376,6 +554,30 @@ struct alignas(Configuration::NumaFriendly
         insertion_buffer.push_back(value);
     }
 
+    // Elements that do not belong into the deletion buffer are collected in full nodes, which are sorted and inserted
+    // into the heap directly. Only the remainder takes the way through the insertion buffer.
+    template <typename InputIt>
+    void push_batch(InputIt first, InputIt last) {
+        typename heap_type::node_type node;
+        std::size_t node_fill = 0;
+        for (; first != last; ++first) {
+            if (deletion_buffer.empty() || first->first < deletion_buffer.back().first) {
+                push(*first);
+                continue;
+            }
+            node[node_fill++] = *first;
+            if (node_fill == Configuration::NodeSize) {
+                std::sort(node.begin(), node.end(),
+                          [&](auto const &lhs, auto const &rhs) { return lhs.first < rhs.first; });
+                heap.insert(node.begin(), node.end());
+                node_fill = 0;
+            }
+        }
+        for (std::size_t i = 0; i < node_fill; ++i) {
+            push(node[i]);
+        }
+    }
+
     void pop() {
         assert(!deletion_buffer.empty());
         deletion_buffer.pop_front();
@@ -389,6 +591,10 @@ struct alignas(Configuration::NumaFriendly
         return insertion_buffer.size() + deletion_buffer.size() + heap.size();
     }
 
+    inline bool is_locked() const noexcept {
+        return (guard.load(std::memory_order_relaxed) >> 31) == 1;
+    }
+
     inline bool try_lock(uint32_t id, bool claiming) const noexcept {
         uint32_t lock_status = guard.load(std::memory_order_relaxed);
         if ((lock_status >> 31) == 1) {
@@ -407,14 +613,27 @@ struct alignas(Configuration::NumaFriendly
     }
 };
 
+// Lets the unit tests lock local queues and serve their delegated requests
+template <typename MultiQueue>
+struct test_access;
+
 template <typename Key, typename T, typename Configuration = configuration::Default,
           typename Allocator = std::allocator<Key>>
-class int_multiqueue : private int_multiqueue_base<Key, T> {
+class int_multiqueue : private int_multiqueue_base<Key, T, typename Configuration::RandomEngine> {
     static_assert(Configuration::WithDeletionBuffer == Configuration::WithInsertionBuffer,
                   "Must use either both or no buffers");
+    static_assert(Configuration::MinK >= 1 && Configuration::MinK <= Configuration::MaxK,
+                  "Stickiness bounds must satisfy 1 <= MinK <= MaxK");
+    static_assert(Configuration::ExtractSampleSize >= 1 && Configuration::InsertSampleSize >= 1,
+                  "At least one queue must be sampled");
+    static_assert(Configuration::DeletionCacheSize == 0 ||
+                      (Configuration::K == 1 && !Configuration::AdaptiveK && !Configuration::UseCombining),
+                  "The deletion cache can not be combined with stickiness or combining");
 
    private:
-    using base_type = int_multiqueue_base<Key, T>;
+    friend struct test_access<int_multiqueue>;
+
+    using base_type = int_multiqueue_base<Key, T, typename Configuration::RandomEngine>;
     using local_queue_type =
         LocalPriorityQueue<Key, T, Configuration, Configuration::UseMergeHeap, Configuration::WithDeletionBuffer>;
     static constexpr auto max_key = local_queue_type::max_key;
@@ -426,6 +645,7 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
     using value_type = typename base_type::value_type;
     using key_comparator = typename base_type::key_comparator;
     using size_type = typename base_type::size_type;
+    using deletion_cache_stats = typename base_type::deletion_cache_stats;
     struct Handle {
         friend class int_multiqueue;
 
@@ -443,48 +663,314 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
     using queue_alloc_type = typename allocator_type::template rebind<local_queue_type>::other;
     using alloc_traits = std::allocator_traits<queue_alloc_type>;
     using base_type::thread_data_;
+    using publication_list_type = util::publication_list<value_type, Configuration::CombiningSlots>;
+    using request = typename publication_list_type::request;
+    enum class delegation { served, failed, locked, full };
+    static constexpr bool measure_quality = Configuration::QualitySampleRate > 0.0;
+    using quality_monitor_type =
+        std::conditional_t<measure_quality, util::quality_monitor<Key>, util::no_quality_monitor>;
+    using stats_collector_type = util::stats_collector<Configuration::CollectStats>;
 
    private:
     local_queue_type *pq_list_;
     size_type pq_list_size_;
     queue_alloc_type alloc_;
+    // Only allocated if `Configuration::UseCombining` is set
+    publication_list_type *publications_ = nullptr;
+    util::parking parking_;
+    alignas(L1_CACHE_LINESIZE) std::atomic_bool terminated_{false};
+    quality_monitor_type quality_monitor_;
+    stats_collector_type stats_;
 
-   public:
-    explicit int_multiqueue(unsigned int const num_threads, std::uint32_t seed = 0,
-                            allocator_type const &alloc = allocator_type())
-        : base_type{num_threads, Configuration::C, seed}, pq_list_size_{num_threads * Configuration::C}, alloc_(alloc) {
-        assert(num_threads >= 1);
-#ifdef MULTIQUEUE_HAVE_NUMA
-        if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_all_nodes_ptr);
+   private:
+    // A sticky queue of the handle was locked by another thread or empty
+    inline void count_sticky_failure(Handle handle) noexcept {
+        if constexpr (Configuration::AdaptiveK) {
+            ++thread_data_[handle.id_].period_failures;
         }
-#endif
-        pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
-        for (std::size_t i = 0; i < pq_list_size_; ++i) {
-            alloc_traits::construct(alloc_, pq_list_ + i);
-#ifdef MULTIQUEUE_ABORT_MISALIGNED
-            if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
-                std::abort();
+    }
+
+    // Ends an operation of the handle. The stickiness is adapted once per period of `stickiness` operations: halved
+    // if a sticky queue failed during the period and doubled otherwise.
+    inline void count_sticky_operation(Handle handle) noexcept {
+        if constexpr (Configuration::AdaptiveK) {
+            auto &data = thread_data_[handle.id_];
+            if (++data.period_operations < data.stickiness) {
+                return;
             }
-#endif
+            data.stickiness = data.period_failures == 0 ? std::min(Configuration::MaxK, 2 * data.stickiness)
+                                                        : std::max(Configuration::MinK, data.stickiness / 2);
+            data.period_operations = 0;
+            data.period_failures = 0;
+        }
+    }
+
+    // Samples `ExtractSampleSize` local queues and selects the one with the smallest top key. The top keys are
+    // prefetched before any of them is compared, so their cache misses overlap. Returns false if all sampled queues
+    // appear empty.
+    bool sample_top_queue(Handle handle, size_type &index) {
+        std::array<size_type, Configuration::ExtractSampleSize> indices;
+        thread_data_[handle.id_].get_random_indices(indices);
+        if constexpr (Configuration::ExtractSampleSize > 2) {
+            for (auto i : indices) {
+                __builtin_prefetch(&pq_list_[i].top_key);
+            }
+        }
+        index = indices[0];
+        Key min_key = pq_list_[indices[0]].top_key.load(std::memory_order_relaxed);
+        for (std::size_t i = 1; i < indices.size(); ++i) {
+            Key const key = pq_list_[indices[i]].top_key.load(std::memory_order_relaxed);
+            if (key < min_key) {
+                index = indices[i];
+                min_key = key;
+            }
+        }
+        return min_key != max_key;
+    }
+
+    // Samples `InsertSampleSize` local queues and selects an unlocked one with the largest top key, as queues holding
+    // few elements tend to have large top keys. Falls back to the first sampled queue if all of them are locked.
+    size_type sample_insert_queue(Handle handle) {
+        if constexpr (Configuration::InsertSampleSize == 1) {
+            return thread_data_[handle.id_].get_random_index();
+        } else {
+            std::array<size_type, Configuration::InsertSampleSize> indices;
+            thread_data_[handle.id_].get_random_indices(indices);
+            for (auto i : indices) {
+                __builtin_prefetch(&pq_list_[i].top_key);
+            }
+            size_type index = indices[0];
+            bool found = false;
+            Key max_top = 0;
+            for (auto i : indices) {
+                if (pq_list_[i].is_locked()) {
+                    continue;
+                }
+                Key const key = pq_list_[i].top_key.load(std::memory_order_relaxed);
+                if (!found || key > max_top) {
+                    index = i;
+                    max_top = key;
+                    found = true;
+                }
+            }
+            return index;
+        }
+    }
+
+    // Failed attempts are counted if `Configuration::CollectStats` is set
+    inline bool try_lock_queue(Handle handle, size_type index, bool claiming) noexcept {
+        if (pq_list_[index].try_lock(handle.id_, claiming)) {
+            return true;
+        }
+        stats_.add(handle.id_, util::counter::lock_failures);
+        return false;
+    }
+
+    // Backs off before the next attempt of an operation
+    template <typename Backoff>
+    inline void retry(Handle handle, Backoff &backoff) {
+        stats_.add(handle.id_, util::counter::retries);
+        backoff();
+    }
+
+    // Locks the queue selected by `sample_top_queue`. Returns false if all sampled queues appear empty, in which case
+    // no queue is locked.
+    bool lock_top_queue(Handle handle, size_type &index) {
+        typename Configuration::Backoff backoff{};
+        while (true) {
+            if (!sample_top_queue(handle, index)) {
+                return false;
+            }
+            if (try_lock_queue(handle, index, true)) {
+                return true;
+            }
+            retry(handle, backoff);
+        }
+    }
+
+    // Must be called before the element becomes visible to other handles
+    inline void track_push(Handle handle, Key key) {
+        stats_.add(handle.id_, util::counter::pushes);
+        if constexpr (measure_quality) {
+            quality_monitor_.on_push(key);
+        }
+    }
+
+    inline void track_extract(Handle handle, Key key) {
+        stats_.add(handle.id_, util::counter::extractions);
+        if constexpr (measure_quality) {
+            quality_monitor_.on_extract(handle.id_, key);
+        }
+    }
+
+    // Always returns false to be usable in return statements
+    inline bool track_empty_extract(Handle handle) noexcept {
+        stats_.add(handle.id_, util::counter::empty_extractions);
+        return false;
+    }
+
+    inline bool pop_cached(Handle handle, value_type &retval) {
+        auto &data = thread_data_[handle.id_];
+        retval = data.cache[data.cache_pos++];
+        if (data.cache_pos == data.cache.size()) {
+            data.cache.clear();
+            data.cache_pos = 0;
         }
+        track_extract(handle, retval.first);
+        return true;
+    }
+
+    // Serves extractions from the deletion cache of the handle as long as the cached minimum is not larger than the
+    // top key of the sampled queues. Otherwise, the cached elements are moved back into the winning queue and the
+    // cache is refilled from it.
+    bool extract_cached(Handle handle, value_type &retval) {
+        auto &data = thread_data_[handle.id_];
+        size_type index;
+        bool found = sample_top_queue(handle, index);
+        if (data.cache_pos < data.cache.size()) {
+            if (!found || data.cache[data.cache_pos].first <= pq_list_[index].top_key.load(std::memory_order_relaxed)) {
+                ++data.cache_stats.served;
+                return pop_cached(handle, retval);
+            }
+            ++data.cache_stats.beaten;
+        }
+        typename Configuration::Backoff backoff{};
+        while (true) {
+            if (!found) {
+                return track_empty_extract(handle);
+            }
+            if (try_lock_queue(handle, index, true)) {
+                break;
+            }
+            // Rather use the cache than waiting for a lock
+            if (data.cache_pos < data.cache.size()) {
+                ++data.cache_stats.served;
+                return pop_cached(handle, retval);
+            }
+            retry(handle, backoff);
+            found = sample_top_queue(handle, index);
+        }
+        if (data.cache_pos < data.cache.size()) {
+            data.cache_stats.returned += data.cache.size() - data.cache_pos;
+            pq_list_[index].push_batch(data.cache.begin() + static_cast<std::ptrdiff_t>(data.cache_pos),
+                                       data.cache.end());
+        }
+        data.cache.clear();
+        data.cache_pos = 0;
+        pq_list_[index].extract_batch(std::back_inserter(data.cache), Configuration::DeletionCacheSize);
+        data.cache_source = index;
+        if (!data.cache.empty()) {
+            data.mark_busy();
+            ++data.cache_stats.refills;
+        }
+        unlock_queue(handle, index);
+        if (data.cache.empty()) {
+            return track_empty_extract(handle);
+        }
+        return pop_cached(handle, retval);
+    }
+
+    // Serves the requests posted to queue `index` before unlocking it
+    inline void unlock_queue(Handle handle, size_type index) {
+        if constexpr (Configuration::UseCombining) {
+            publications_[index].combine([this, index](request kind, std::uint32_t id, value_type &value) {
+                if (kind == request::push) {
+                    pq_list_[index].push(value);
+                    return true;
+                }
+                if (pq_list_[index].extract_top(value)) {
+                    // The requester waits for us, so we can safely mark it busy on its behalf
+                    thread_data_[id].mark_busy();
+                    return true;
+                }
+                return false;
+            });
+        }
+        stats_.take(handle.id_, pq_list_[index].stats);
+        pq_list_[index].unlock(handle.id_);
+    }
+
+    // Posts a request to the contended queue `index` and waits until it is served or the lock of the queue could be
+    // acquired. In the latter case the request is withdrawn and the queue remains locked. The result of a served
+    // extraction is written to `value`.
+    delegation delegate(Handle handle, size_type index, request kind, value_type &value) {
+        auto &publications = publications_[index];
+        auto const slot = publications.post(kind, handle.id_, value);
+        if (slot == publication_list_type::npos) {
+            return delegation::full;
+        }
+        while (true) {
+            auto state = publications.poll(slot);
+            if (state != request::done && state != request::failed) {
+                if (!pq_list_[index].try_lock(handle.id_, true)) {
+                    util::cpu_relax();
+                    continue;
+                }
+                // Requests are only served by lock holders, so the state is stable now
+                state = publications.poll(slot);
+                if (state != request::done && state != request::failed) {
+                    publications.release(slot);
+                    return delegation::locked;
+                }
+                unlock_queue(handle, index);
+            }
+            if (state == request::done && kind == request::extract) {
+                value = publications.value(slot);
+            }
+            publications.release(slot);
+            return state == request::done ? delegation::served : delegation::failed;
+        }
+    }
+
+    // Reserves space for `per_queue` elements in each local queue. Numa friendly queues are touched in parallel by
+    // one worker per handle, each running on the node its queues are placed on. Otherwise, only address space is
+    // reserved and the pages are populated by the threads pushing into the queues.
+    void reserve_queues(std::size_t const per_queue) {
 #ifdef MULTIQUEUE_HAVE_NUMA
         if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_no_nodes_ptr);
+            util::parallel_first_touch(
+                pq_list_size_, static_cast<unsigned int>(pq_list_size_ / Configuration::C),
+                [this, per_queue](std::size_t i) { pq_list_[i].heap.reserve_and_touch(per_queue); });
+            return;
         }
 #endif
         for (std::size_t i = 0; i < pq_list_size_; ++i) {
+            pq_list_[i].heap.reserve(per_queue);
+        }
+    }
+
+   public:
+    explicit int_multiqueue(unsigned int const num_threads, std::uint32_t seed = 0,
+                            allocator_type const &alloc = allocator_type())
+        : base_type{num_threads, Configuration::C, seed},
+          pq_list_size_{num_threads * Configuration::C},
+          alloc_(alloc),
+          quality_monitor_{num_threads, Configuration::QualitySampleRate},
+          stats_{num_threads} {
+        assert(num_threads >= 1);
+        for (unsigned int i = 0; i < num_threads; ++i) {
+            thread_data_[i].stickiness = std::clamp(Configuration::K, Configuration::MinK, Configuration::MaxK);
+            thread_data_[i].cache.reserve(Configuration::DeletionCacheSize);
+        }
+        if (Configuration::UseCombining) {
+            publications_ = new publication_list_type[pq_list_size_];
+        }
+        {
+            // Only the queue array is interleaved, the heaps are placed by first touch
 #ifdef MULTIQUEUE_HAVE_NUMA
-            if (Configuration::NumaFriendly) {
-                numa_set_preferred(
-                    static_cast<int>(i / (pq_list_size_ / (static_cast<std::size_t>(numa_max_node()) + 1))));
-                pq_list_[i].heap.reserve_and_touch(Configuration::ReservePerQueue);
-                numa_set_preferred(-1);
-            }
-#else
-            pq_list_[i].heap.reserve(Configuration::ReservePerQueue);
+            util::interleave_scope interleave{Configuration::NumaFriendly};
 #endif
+            pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
+            for (std::size_t i = 0; i < pq_list_size_; ++i) {
+                alloc_traits::construct(alloc_, pq_list_ + i);
+#ifdef MULTIQUEUE_ABORT_MISALIGNED
+                if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
+                    std::abort();
+                }
+#endif
+            }
         }
+        reserve_queues(Configuration::ReservePerQueue);
     }
 
     ~int_multiqueue() noexcept {
@@ -492,70 +978,182 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
             alloc_traits::destroy(alloc_, pq_list_ + i);
         }
         alloc_traits::deallocate(alloc_, pq_list_, pq_list_size_);
+        delete[] publications_;
     }
 
     Handle get_handle(unsigned int id) const noexcept {
         return Handle{id};
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1), int> = 0>
+    // Reserves space for `expected_size` elements in total, split evenly over all local queues. Must not be called
+    // concurrently with other operations.
+    void reserve(size_type const expected_size) {
+        reserve_queues((expected_size + pq_list_size_ - 1) / pq_list_size_);
+    }
+
+    // Binds the handle to `node` out of `num_nodes` numa nodes, so that it mostly samples the queues placed on this
+    // node. Should be called by the thread owning the handle. Also usable to emulate numa nodes without numa support.
+    void set_numa_node(Handle handle, unsigned int node, unsigned int num_nodes) {
+        auto const [first, last] = util::numa_local_range(pq_list_size_, node, num_nodes);
+        thread_data_[handle.id_].set_local_range(first, last, Configuration::NumaRemoteProbability);
+    }
+
+    // Binds the handle to the numa node of the cpu the calling thread runs on, which should be pinned
+    void set_numa_node(Handle handle) {
+        set_numa_node(handle, util::current_numa_node(), util::numa_node_count());
+    }
+
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1 && !Configuration::AdaptiveK), int> = 0>
     void push(Handle handle, value_type const &value) {
-        size_type index = thread_data_[handle.id_].get_random_index();
-        while (!pq_list_[index].try_lock(handle.id_, true)) {
-            index = thread_data_[handle.id_].get_random_index();
+        track_push(handle, value.first);
+        size_type index = sample_insert_queue(handle);
+        typename Configuration::Backoff backoff{};
+        while (!try_lock_queue(handle, index, true)) {
+            if constexpr (Configuration::UseCombining) {
+                value_type request_value = value;
+                auto const result = delegate(handle, index, request::push, request_value);
+                if (result == delegation::served) {
+                    parking_.notify();
+                    return;
+                }
+                if (result == delegation::locked) {
+                    break;
+                }
+            }
+            retry(handle, backoff);
+            index = sample_insert_queue(handle);
         }
         pq_list_[index].push(value);
-        pq_list_[index].unlock(handle.id_);
+        unlock_queue(handle, index);
+        parking_.notify();
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1), int> = 0>
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1 || Configuration::AdaptiveK), int> = 0>
     void push(Handle handle, value_type const &value) {
+        track_push(handle, value.first);
         auto &index = thread_data_[handle.id_].insert_index;
-        if (thread_data_[handle.id_].insert_count == 0 || !pq_list_[index].try_lock(handle.id_, false)) {
-            do {
-                index = thread_data_[handle.id_].get_random_index();
-            } while (!pq_list_[index].try_lock(handle.id_, true));
-            thread_data_[handle.id_].insert_count = Configuration::K;
+        if (thread_data_[handle.id_].insert_count == 0 || !try_lock_queue(handle, index, false)) {
+            if (thread_data_[handle.id_].insert_count != 0) {
+                count_sticky_failure(handle);
+            }
+            typename Configuration::Backoff backoff{};
+            index = sample_insert_queue(handle);
+            while (!try_lock_queue(handle, index, true)) {
+                retry(handle, backoff);
+                index = sample_insert_queue(handle);
+            }
+            thread_data_[handle.id_].insert_count = stickiness(handle);
         }
         pq_list_[index].push(value);
-        pq_list_[index].unlock(handle.id_);
+        unlock_queue(handle, index);
+        parking_.notify();
         --thread_data_[handle.id_].insert_count;
+        count_sticky_operation(handle);
+    }
+
+    // Moves the elements left in the deletion cache of the handle back into a local queue, so that they become
+    // reachable for other handles. Should be called by a handle that stops extracting.
+    void flush(Handle handle) {
+        if constexpr (Configuration::DeletionCacheSize > 0) {
+            auto &data = thread_data_[handle.id_];
+            if (data.cache_pos == data.cache.size()) {
+                return;
+            }
+            size_type index = sample_insert_queue(handle);
+            typename Configuration::Backoff backoff{};
+            while (!try_lock_queue(handle, index, true)) {
+                retry(handle, backoff);
+                index = sample_insert_queue(handle);
+            }
+            data.cache_stats.returned += data.cache.size() - data.cache_pos;
+            pq_list_[index].push_batch(data.cache.begin() + static_cast<std::ptrdiff_t>(data.cache_pos),
+                                       data.cache.end());
+            data.cache.clear();
+            data.cache_pos = 0;
+            unlock_queue(handle, index);
+            parking_.notify();
+        }
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1), int> = 0>
+    // Inserts all elements in [first, last) into one randomly chosen local queue, which is locked only once. Since
+    // the whole batch ends up in the same queue, very large batches increase the rank error of later deletions.
+    template <typename InputIt>
+    void push_batch(Handle handle, InputIt first, InputIt last) {
+        if (first == last) {
+            return;
+        }
+        size_type index = sample_insert_queue(handle);
+        typename Configuration::Backoff backoff{};
+        while (!try_lock_queue(handle, index, true)) {
+            retry(handle, backoff);
+            index = sample_insert_queue(handle);
+        }
+        if constexpr (measure_quality) {
+            for (; first != last; ++first) {
+                track_push(handle, first->first);
+                pq_list_[index].push(*first);
+            }
+        } else if constexpr (Configuration::CollectStats) {
+            auto const size = pq_list_[index].size();
+            pq_list_[index].push_batch(first, last);
+            stats_.add(handle.id_, util::counter::pushes, pq_list_[index].size() - size);
+        } else {
+            pq_list_[index].push_batch(first, last);
+        }
+        unlock_queue(handle, index);
+        parking_.notify();
+    }
+
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1 && !Configuration::AdaptiveK), int> = 0>
     bool extract_top(Handle handle, value_type &retval) {
-        size_type first_index;
-        size_type second_index;
-        Key first_key;
-        Key second_key;
-
-        do {
-            first_index = thread_data_[handle.id_].get_random_index();
-            second_index = thread_data_[handle.id_].get_random_index();
-            first_key = pq_list_[first_index].top_key.load(std::memory_order_relaxed);
-            second_key = pq_list_[second_index].top_key.load(std::memory_order_relaxed);
-            if (second_key < first_key) {
-                first_index = second_index;
-                first_key = second_key;
-            }
-            if (first_key == max_key) {
-                return false;
+        if constexpr (Configuration::DeletionCacheSize > 0) {
+            return extract_cached(handle, retval);
+        }
+        size_type index;
+        if constexpr (Configuration::UseCombining) {
+            typename Configuration::Backoff backoff{};
+            while (true) {
+                if (!sample_top_queue(handle, index)) {
+                    return track_empty_extract(handle);
+                }
+                if (try_lock_queue(handle, index, true)) {
+                    break;
+                }
+                auto const result = delegate(handle, index, request::extract, retval);
+                if (result == delegation::served) {
+                    track_extract(handle, retval.first);
+                    return true;
+                }
+                if (result == delegation::locked) {
+                    break;
+                }
+                retry(handle, backoff);
             }
-        } while (!pq_list_[first_index].try_lock(handle.id_, true));
-        bool success = pq_list_[first_index].extract_top(retval);
-        pq_list_[first_index].unlock(handle.id_);
+        } else if (!lock_top_queue(handle, index)) {
+            return track_empty_extract(handle);
+        }
+        bool success = pq_list_[index].extract_top(retval);
+        if (success) {
+            thread_data_[handle.id_].mark_busy();
+        }
+        unlock_queue(handle, index);
+        if (success) {
+            track_extract(handle, retval.first);
+        } else {
+            track_empty_extract(handle);
+        }
         return success;
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1), int> = 0>
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1 || Configuration::AdaptiveK), int> = 0>
     bool extract_top(Handle handle, value_type &retval) {
         if (thread_data_[handle.id_].extract_count[0] == 0) {
             thread_data_[handle.id_].extract_index[0] = thread_data_[handle.id_].get_random_index();
-            thread_data_[handle.id_].extract_count[0] = Configuration::K;
+            thread_data_[handle.id_].extract_count[0] = stickiness(handle);
         }
         if (thread_data_[handle.id_].extract_count[1] == 0) {
             thread_data_[handle.id_].extract_index[1] = thread_data_[handle.id_].get_random_index();
-            thread_data_[handle.id_].extract_count[0] = Configuration::K;
+            thread_data_[handle.id_].extract_count[1] = stickiness(handle);
         }
         auto &first_index = thread_data_[handle.id_].extract_index[0];
         auto &second_index = thread_data_[handle.id_].extract_index[1];
@@ -565,7 +1163,9 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
         if (first_key == max_key && second_key == max_key) {
             thread_data_[handle.id_].extract_count[0] = 0;
             thread_data_[handle.id_].extract_count[1] = 0;
-            return false;
+            count_sticky_failure(handle);
+            count_sticky_operation(handle);
+            return track_empty_extract(handle);
         }
 
         if (second_key < first_key) {
@@ -574,62 +1174,246 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
             std::swap(thread_data_[handle.id_].extract_count[0], thread_data_[handle.id_].extract_count[1]);
         }
 
-        if (!pq_list_[first_index].try_lock(handle.id_,
-                                            thread_data_[handle.id_].extract_count[0] == Configuration::K)) {
+        if (!try_lock_queue(handle, first_index, thread_data_[handle.id_].extract_count[0] == stickiness(handle))) {
+            count_sticky_failure(handle);
+            typename Configuration::Backoff backoff{};
             do {
-                first_index = thread_data_[handle.id_].get_random_index();
-                second_index = thread_data_[handle.id_].get_random_index();
+                retry(handle, backoff);
+                thread_data_[handle.id_].get_random_indices(first_index, second_index);
                 first_key = pq_list_[first_index].top_key.load(std::memory_order_relaxed);
                 second_key = pq_list_[second_index].top_key.load(std::memory_order_relaxed);
                 if (first_key == max_key && second_key == max_key) {
                     thread_data_[handle.id_].extract_count[0] = 0;
                     thread_data_[handle.id_].extract_count[1] = 0;
-                    return false;
+                    count_sticky_operation(handle);
+                    return track_empty_extract(handle);
                 }
                 if (second_key < first_key) {
                     std::swap(first_index, second_index);
                     std::swap(first_key, second_key);
                     std::swap(thread_data_[handle.id_].extract_count[0], thread_data_[handle.id_].extract_count[1]);
                 }
-            } while (!pq_list_[first_index].try_lock(handle.id_, true));
-            thread_data_[handle.id_].extract_count[0] = Configuration::K;
-            thread_data_[handle.id_].extract_count[1] = Configuration::K;
+            } while (!try_lock_queue(handle, first_index, true));
+            thread_data_[handle.id_].extract_count[0] = stickiness(handle);
+            thread_data_[handle.id_].extract_count[1] = stickiness(handle);
         }
 
         bool success = pq_list_[first_index].extract_top(retval);
-        pq_list_[first_index].unlock(handle.id_);
         if (success) {
-            --thread_data_[handle.id_].extract_count[0];
-        } else {
+            thread_data_[handle.id_].mark_busy();
+        }
+        unlock_queue(handle, first_index);
+        if (!success) {
             thread_data_[handle.id_].extract_count[0] = 0;
+            count_sticky_failure(handle);
+        } else {
+            --thread_data_[handle.id_].extract_count[0];
         }
-        if (second_key != max_key) {
+        if (second_key == max_key) {
+            thread_data_[handle.id_].extract_count[1] = 0;
+        } else {
             --thread_data_[handle.id_].extract_count[1];
+        }
+        count_sticky_operation(handle);
+        if (success) {
+            track_extract(handle, retval.first);
         } else {
-            thread_data_[handle.id_].extract_count[1] = 0;
+            track_empty_extract(handle);
         }
         return success;
     }
 
+    // Extracts up to `n` elements from the local queue selected as in `extract_top` while holding its lock only once.
+    // The elements are written to `out` in ascending order and the number of extracted elements is returned. With a
+    // deletion cache, the cached elements of the handle are returned first and a local queue is only locked if the
+    // cache holds fewer than `n` elements, so the batch is not sorted as a whole.
+    template <typename OutputIt>
+    size_type extract_batch(Handle handle, OutputIt out, size_type n) {
+        size_type count = 0;
+        if constexpr (Configuration::DeletionCacheSize > 0) {
+            value_type value;
+            for (; count < n && thread_data_[handle.id_].cache_pos < thread_data_[handle.id_].cache.size(); ++count) {
+                pop_cached(handle, value);
+                *out++ = value;
+            }
+            thread_data_[handle.id_].cache_stats.served += count;
+        }
+        if (count == n) {
+            return count;
+        }
+        size_type index;
+        if (!lock_top_queue(handle, index)) {
+            if (count == 0) {
+                track_empty_extract(handle);
+            }
+            return count;
+        }
+        size_type locked_count = 0;
+        if constexpr (measure_quality) {
+            value_type value;
+            for (; count + locked_count < n && pq_list_[index].extract_top(value); ++locked_count) {
+                track_extract(handle, value.first);
+                *out++ = value;
+            }
+        } else {
+            locked_count = pq_list_[index].extract_batch(out, n - count);
+            stats_.add(handle.id_, util::counter::extractions, locked_count);
+        }
+        if (locked_count > 0) {
+            thread_data_[handle.id_].mark_busy();
+        }
+        unlock_queue(handle, index);
+        return count + locked_count;
+    }
+
+    // Like `extract_top`, but if no element is found after `Configuration::WaitSpins` attempts, the thread sleeps until
+    // an element is pushed or `timeout` elapsed. Returns false only on timeout.
+    template <typename Rep, typename Period>
+    bool extract_top_wait(Handle handle, value_type &retval, std::chrono::duration<Rep, Period> const &timeout) {
+        for (unsigned int i = 0; i < Configuration::WaitSpins; ++i) {
+            if (extract_top(handle, retval)) {
+                return true;
+            }
+            util::cpu_relax();
+        }
+        auto const deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            auto const epoch = parking_.prepare_park();
+            // Re-check after announcing ourselves, as the element could have been pushed in between
+            if (extract_top(handle, retval)) {
+                parking_.cancel_park();
+                return true;
+            }
+            auto const now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                parking_.cancel_park();
+                return false;
+            }
+            parking_.park(epoch, deadline - now);
+            if (extract_top(handle, retval)) {
+                return true;
+            }
+        }
+    }
+
+    // Marks the handle as idle until its next successful extraction and returns true if all handles are idle and all
+    // queues are empty. A handle must not push while idle, so once this returns true, the computation has terminated
+    // and all subsequent calls return true as well. Intended to be called by workers after `extract_top` failed.
+    bool try_terminate(Handle handle) {
+        if (terminated_.load(std::memory_order_acquire)) {
+            return true;
+        }
+        auto &own_epoch = thread_data_[handle.id_].idle_epoch;
+        auto const epoch = own_epoch.load(std::memory_order_relaxed);
+        if (epoch % 2 == 0) {
+            own_epoch.store(epoch + 1, std::memory_order_seq_cst);
+        }
+        size_type const num_threads = pq_list_size_ / Configuration::C;
+        // Epochs never decrease, so an unchanged sum means that no handle became busy in between
+        std::uint64_t epoch_sum = 0;
+        for (size_type i = 0; i < num_threads; ++i) {
+            auto const e = thread_data_[i].idle_epoch.load(std::memory_order_seq_cst);
+            if (e % 2 == 0) {
+                return false;
+            }
+            epoch_sum += e;
+        }
+        typename Configuration::Backoff backoff{};
+        for (size_type i = 0; i < pq_list_size_; ++i) {
+            while (!pq_list_[i].try_lock(handle.id_, true)) {
+                backoff();
+            }
+            bool const empty = pq_list_[i].empty();
+            unlock_queue(handle, i);
+            if (!empty) {
+                return false;
+            }
+        }
+        for (size_type i = 0; i < num_threads; ++i) {
+            epoch_sum -= thread_data_[i].idle_epoch.load(std::memory_order_seq_cst);
+        }
+        if (epoch_sum != 0) {
+            return false;
+        }
+        terminated_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Extracts from the `C` queues of the handle's partition. With a deletion cache, the cached elements of the handle
+    // are extracted first, regardless of the queue they were taken from.
     bool extract_from_partition(Handle handle, value_type &retval) {
+        if constexpr (Configuration::DeletionCacheSize > 0) {
+            if (thread_data_[handle.id_].cache_pos < thread_data_[handle.id_].cache.size()) {
+                ++thread_data_[handle.id_].cache_stats.served;
+                return pop_cached(handle, retval);
+            }
+        }
         for (size_type i = Configuration::C * handle.id_; i < Configuration::C * (handle.id_ + 1); ++i) {
             if (pq_list_[i].top_key.load(std::memory_order_acquire) == max_key ||
-                !pq_list_[i].try_lock(handle.id_, true)) {
+                !try_lock_queue(handle, i, true)) {
                 continue;
             }
             bool success = pq_list_[i].extract_top(retval);
-            pq_list_[i].unlock(handle.id_);
             if (success) {
+                thread_data_[handle.id_].mark_busy();
+            }
+            unlock_queue(handle, i);
+            if (success) {
+                track_extract(handle, retval.first);
                 return true;
             }
         }
         return false;
     }
 
+    // Current stickiness of the handle, which is adapted at runtime if `Configuration::AdaptiveK` is set. Should only
+    // be called by the thread owning the handle.
+    inline unsigned int stickiness(Handle handle) const noexcept {
+        if constexpr (Configuration::AdaptiveK) {
+            return thread_data_[handle.id_].stickiness;
+        } else {
+            return Configuration::K;
+        }
+    }
+
+    // Rank error and delay of the sampled extractions of the handle, which can be read while the queue is in use.
+    // Only available if `Configuration::QualitySampleRate` is positive.
+    util::quality_histograms get_quality_histograms(Handle handle) const noexcept {
+        static_assert(measure_quality, "Quality is not measured");
+        return quality_monitor_.histograms(handle.id_);
+    }
+
+    // Rank error and delay of the sampled extractions of all handles
+    util::quality_histograms get_quality_histograms() const noexcept {
+        static_assert(measure_quality, "Quality is not measured");
+        return quality_monitor_.histograms();
+    }
+
+    // Operation counters of the handle, which can be read while the queue is in use. Counters of the work inside a
+    // local queue are attributed to the handle unlocking it. Only available if `Configuration::CollectStats` is set.
+    util::operation_stats stats(Handle handle) const noexcept {
+        static_assert(Configuration::CollectStats, "Stats are not collected");
+        return stats_.get(handle.id_);
+    }
+
+    // Operation counters summed over all handles
+    util::operation_stats stats() const noexcept {
+        static_assert(Configuration::CollectStats, "Stats are not collected");
+        return stats_.get();
+    }
+
+    // Elements in a deletion cache are counted in the queue they were taken from. Must not be called concurrently with
+    // other operations.
     std::vector<std::size_t> get_distribution() const {
         std::vector<std::size_t> distribution(pq_list_size_);
         std::transform(pq_list_, pq_list_ + pq_list_size_, distribution.begin(),
                        [](auto const &pq_wrapper) { return pq_wrapper.size(); });
+        if constexpr (Configuration::DeletionCacheSize > 0) {
+            for (size_type i = 0; i < pq_list_size_ / Configuration::C; ++i) {
+                auto const &data = thread_data_[i];
+                distribution[data.cache_source] += data.cache.size() - data.cache_pos;
+            }
+        }
         return distribution;
     }
 
@@ -659,6 +1443,18 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
         return distribution;
     }
 
+    // Only meaningful while no handle is in use
+    deletion_cache_stats get_deletion_cache_stats() const {
+        deletion_cache_stats stats;
+        for (size_type i = 0; i < pq_list_size_ / Configuration::C; ++i) {
+            stats.served += thread_data_[i].cache_stats.served;
+            stats.refills += thread_data_[i].cache_stats.refills;
+            stats.beaten += thread_data_[i].cache_stats.beaten;
+            stats.returned += thread_data_[i].cache_stats.returned;
+        }
+        return stats;
+    }
+
     void push_in_queue(value_type const &value, std::size_t index) {
     }
 
@@ -666,7 +1462,12 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
         std::stringstream ss;
         ss << "int multiqueue\n\t";
         ss << "C: " << Configuration::C << "\n\t";
-        ss << "K: " << Configuration::K << "\n\t";
+        if (Configuration::AdaptiveK) {
+            ss << "K: adaptive in [" << Configuration::MinK << ", " << Configuration::MaxK << "], starting at "
+               << Configuration::K << "\n\t";
+        } else {
+            ss << "K: " << Configuration::K << "\n\t";
+        }
         if (Configuration::UseMergeHeap) {
             ss << "Using merge heap, node size: " << Configuration::NodeSize << "\n\t";
         } else {
@@ -679,7 +1480,7 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
             ss << "Heap degree: " << Configuration::HeapDegree << "\n\t";
         }
         if (Configuration::NumaFriendly) {
-            ss << "Numa friendly\n\t";
+            ss << "Numa friendly, remote probability: " << Configuration::NumaRemoteProbability << "\n\t";
 #ifndef MULTIQUEUE_HAVE_NUMA
             ss << "But numasupport disabled!\n\t";
 #endif
@@ -690,6 +1491,23 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
         if (Configuration::WithPheromones) {
             ss << "Using pheromones\n\t";
         }
+        ss << "Sampling " << Configuration::ExtractSampleSize << " queues per extraction and "
+           << Configuration::InsertSampleSize << " per insertion\n\t";
+        if (Configuration::DeletionCacheSize > 0) {
+            ss << "Caching up to " << Configuration::DeletionCacheSize << " minima per handle\n\t";
+        }
+        if (measure_quality) {
+            ss << "Measuring rank error and delay of " << Configuration::QualitySampleRate << " of the keys\n\t";
+        }
+        if (Configuration::CollectStats) {
+            ss << "Collecting operation stats\n\t";
+        }
+        if (Configuration::UseCombining) {
+            ss << "Using combining with " << Configuration::CombiningSlots << " slots per queue\n\t";
+        }
+        if (Configuration::HeapBlockSize > 0) {
+            ss << "Heap storage in blocks of " << Configuration::HeapBlockSize << " elements\n\t";
+        }
         ss << "Preallocation for " << Configuration::ReservePerQueue << " elements per internal pq";
         return ss.str();
     }
@@ -697,4 +1515,4 @@ class int_multiqueue : private int_multiqueue_base<Key, T> {
 
 }  // namespace multiqueue
 
-#endif  //! MULTIQUEUE_HPP_INCLUDED
+#endif  //! INT_MULTIQUEUE_HPP_INCLUDED
@@ -1,6 +1,6 @@
 /**
 ******************************************************************************
-* @file:   multiqueue.hpp
+* @file:   int_multiqueue_assigned.hpp
 *
 * @author: Marvin Williams
 * @date:   2021/03/29 17:19
@@ -15,6 +15,8 @@
 #include "multiqueue/sequential/heap/heap.hpp"
 #include "multiqueue/util/buffer.hpp"
 #include "multiqueue/util/extractors.hpp"
+#include "multiqueue/util/numa.hpp"
+#include "multiqueue/util/random.hpp"
 #include "multiqueue/util/ring_buffer.hpp"
 #include "sequential/heap/heap.hpp"
 #include "system_config.hpp"
@@ -36,7 +38,7 @@
 
 namespace multiqueue {
 
-template <typename Key, typename T>
+template <typename Key, typename T, typename Configuration>
 struct int_multiqueue_assigned_base {
     static_assert(std::is_unsigned_v<Key>, "Key must be unsigned integer");
     using key_type = Key;
@@ -57,7 +59,7 @@ struct int_multiqueue_assigned_base {
 
    protected:
     struct alignas(2 * L1_CACHE_LINESIZE) ThreadData {
-        std::mt19937 gen;
+        util::index_sampler<typename Configuration::RandomEngine> sampler;
         unsigned int insert_count = 0;
         unsigned int extract_count = 0;
     };
@@ -69,27 +71,31 @@ struct int_multiqueue_assigned_base {
     std::uint32_t reserve(unsigned int id, unsigned int num) {
         assert(num < 3);
         auto i = queue_index_[3 * id + num].index.load(std::memory_order_relaxed);
+        typename Configuration::Backoff backoff{};
         while (!queue_index_[3 * id + num].index.compare_exchange_weak(i, i | (1u << 31), std::memory_order_acquire,
                                                                        std::memory_order_relaxed)) {
+            backoff();
         }
         return i;
     }
 
-    template <typename RNG>
-    void swap_assignment(unsigned int id, unsigned int num, RNG &&g) {
+    template <typename Sampler>
+    void swap_assignment(unsigned int id, unsigned int num, Sampler &&sample) {
         auto assignment = reserve(id, num);
-        std::uniform_int_distribution<std::uint32_t> dist(0, pq_list_size_ - 1);
+        typename Configuration::Backoff backoff{};
         do {
-            auto swap_index = dist(g);
+            auto swap_index = sample();
             auto other_assignment = queue_index_[swap_index].index.load(std::memory_order_relaxed);
             if (is_reserved(other_assignment)) {
+                backoff();
                 continue;
             }
             if (queue_index_[swap_index].index.compare_exchange_strong(
                     other_assignment, assignment, std::memory_order_acq_rel, std::memory_order_relaxed)) {
-                queue_index_[3 * id + num].index.store(other_assignment, std::memory_order_acq_rel);
+                queue_index_[3 * id + num].index.store(other_assignment, std::memory_order_release);
                 break;
             }
+            backoff();
         } while (true);
     }
 
@@ -106,7 +112,8 @@ struct int_multiqueue_assigned_base {
         thread_data_ = new ThreadData[num_threads]();
         for (std::size_t i = 0; i < num_threads; ++i) {
             std::seed_seq seq{seed + i};
-            thread_data_[i].gen.seed(seq);
+            thread_data_[i].sampler.seed(seq);
+            thread_data_[i].sampler.set_size(pq_list_size_);
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
             if (reinterpret_cast<std::uintptr_t>(&thread_data_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
                 std::abort();
@@ -135,7 +142,8 @@ struct alignas(Configuration::NumaFriendly ? PAGESIZE : 2 * L1_CACHE_LINESIZE) L
     using allocator_type = typename Configuration::HeapAllocator;
     using heap_type =
         sequential::key_value_heap<Key, T, std::less<Key>, Configuration::HeapDegree,
-                                   typename Configuration::SiftStrategy, typename Configuration::HeapAllocator>;
+                                   typename Configuration::SiftStrategy, typename Configuration::HeapAllocator,
+                                   Configuration::HeapBlockSize>;
     static constexpr uint32_t lock_mask = static_cast<uint32_t>(1) << 31;
     static constexpr Key max_key = std::numeric_limits<Key>::max();
 
@@ -238,12 +246,12 @@ struct alignas(Configuration::NumaFriendly ? PAGESIZE : 2 * L1_CACHE_LINESIZE) L
 
 template <typename Key, typename T, typename Configuration = configuration::Default,
           typename Allocator = std::allocator<Key>>
-class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
+class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T, Configuration> {
     static_assert(Configuration::WithDeletionBuffer == Configuration::WithInsertionBuffer,
                   "Must use either both or no buffers");
 
    private:
-    using base_type = int_multiqueue_assigned_base<Key, T>;
+    using base_type = int_multiqueue_assigned_base<Key, T, Configuration>;
     using local_queue_type = LocalPriorityQueueAssigned<Key, T, Configuration>;
     static constexpr auto max_key = local_queue_type::max_key;
 
@@ -283,36 +291,32 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
                                      allocator_type const &alloc = allocator_type())
         : base_type{num_threads, Configuration::C, seed}, alloc_(alloc) {
         assert(num_threads >= 1);
+        {
+            // Only the queue array is interleaved, the heaps are placed by first touch
 #ifdef MULTIQUEUE_HAVE_NUMA
-        if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_all_nodes_ptr);
-        }
+            util::interleave_scope interleave{Configuration::NumaFriendly};
 #endif
-        pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
-        for (std::size_t i = 0; i < pq_list_size_; ++i) {
-            alloc_traits::construct(alloc_, pq_list_ + i);
+            pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
+            for (std::size_t i = 0; i < pq_list_size_; ++i) {
+                alloc_traits::construct(alloc_, pq_list_ + i);
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
-            if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
-                std::abort();
-            }
+                if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
+                    std::abort();
+                }
 #endif
+            }
         }
 #ifdef MULTIQUEUE_HAVE_NUMA
         if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_no_nodes_ptr);
+            // Touched in parallel by one worker per handle, each running on the node its queues are placed on
+            util::parallel_first_touch(
+                pq_list_size_, static_cast<unsigned int>(pq_list_size_ / Configuration::C),
+                [this](std::size_t i) { pq_list_[i].heap.reserve_and_touch(Configuration::ReservePerQueue); });
+            return;
         }
 #endif
         for (std::size_t i = 0; i < pq_list_size_; ++i) {
-#ifdef MULTIQUEUE_HAVE_NUMA
-            if (Configuration::NumaFriendly) {
-                numa_set_preferred(
-                    static_cast<int>(i / (pq_list_size_ / (static_cast<std::size_t>(numa_max_node()) + 1))));
-                pq_list_[i].heap.reserve_and_touch(Configuration::ReservePerQueue);
-                numa_set_preferred(-1);
-            }
-#else
             pq_list_[i].heap.reserve(Configuration::ReservePerQueue);
-#endif
         }
     }
 
@@ -329,11 +333,12 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
 
     template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1), int> = 0>
     void push(Handle handle, value_type const &value) {
-        std::uniform_int_distribution<std::uint32_t> dist(0, pq_list_size_ - 1);
-        size_type index;
-        do {
-            index = dist(thread_data_[handle.id_].gen);
-        } while (!pq_list_[index].try_lock());
+        size_type index = thread_data_[handle.id_].sampler();
+        typename Configuration::Backoff backoff{};
+        while (!pq_list_[index].try_lock()) {
+            backoff();
+            index = thread_data_[handle.id_].sampler();
+        }
         pq_list_[index].push(value);
         pq_list_[index].unlock();
     }
@@ -341,14 +346,15 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
     template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1), int> = 0>
     void push(Handle handle, value_type const &value) {
         if (thread_data_[handle.id_].insert_count == 0) {
-            this->swap_assignment(handle.id_, 0, thread_data_[handle.id_].gen);
+            this->swap_assignment(handle.id_, 0, thread_data_[handle.id_].sampler);
             thread_data_[handle.id_].insert_count = Configuration::K;
         }
         auto index = queue_index_[3 * handle.id_].index.load(std::memory_order_relaxed);
         if (!pq_list_[index].try_lock()) {
-            std::uniform_int_distribution<std::uint32_t> dist(0, pq_list_size_ - 1);
+            typename Configuration::Backoff backoff{};
             do {
-                index = dist(thread_data_[handle.id_].gen);
+                backoff();
+                index = thread_data_[handle.id_].sampler();
             } while (!pq_list_[index].try_lock());
         }
         pq_list_[index].push(value);
@@ -363,10 +369,9 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
         Key first_key;
         Key second_key;
 
-        std::uniform_int_distribution<std::uint32_t> dist(0, pq_list_size_ - 1);
-        do {
-            first_index = dist(thread_data_[handle.id_].gen);
-            second_index = dist(thread_data_[handle.id_].gen);
+        typename Configuration::Backoff backoff{};
+        while (true) {
+            thread_data_[handle.id_].sampler(first_index, second_index);
             first_key = pq_list_[first_index].top_key.load(std::memory_order_relaxed);
             second_key = pq_list_[second_index].top_key.load(std::memory_order_relaxed);
             if (second_key < first_key) {
@@ -376,7 +381,11 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
             if (first_key == max_key) {
                 return false;
             }
-        } while (!pq_list_[first_index].try_lock());
+            if (pq_list_[first_index].try_lock()) {
+                break;
+            }
+            backoff();
+        }
         bool success = pq_list_[first_index].extract_top(retval);
         pq_list_[first_index].unlock();
         return success;
@@ -385,12 +394,12 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
     template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1), int> = 0>
     bool extract_top(Handle handle, value_type &retval) {
         if (thread_data_[handle.id_].extract_count == 0) {
-            this->swap_assignment(handle.id_, 1, thread_data_[handle.id_].gen);
-            this->swap_assignment(handle.id_, 2, thread_data_[handle.id_].gen);
+            this->swap_assignment(handle.id_, 1, thread_data_[handle.id_].sampler);
+            this->swap_assignment(handle.id_, 2, thread_data_[handle.id_].sampler);
             thread_data_[handle.id_].extract_count = Configuration::K;
         }
-        auto first_index = queue_index_[3 * handle.id_ + 1].index.load(std::memory_order_relaxed);
-        auto second_index = queue_index_[3 * handle.id_ + 2].index.load(std::memory_order_relaxed);
+        size_type first_index = queue_index_[3 * handle.id_ + 1].index.load(std::memory_order_relaxed);
+        size_type second_index = queue_index_[3 * handle.id_ + 2].index.load(std::memory_order_relaxed);
         Key first_key = pq_list_[first_index].top_key.load(std::memory_order_relaxed);
         Key second_key = pq_list_[second_index].top_key.load(std::memory_order_relaxed);
 
@@ -405,10 +414,10 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
         }
 
         if (!pq_list_[first_index].try_lock()) {
-            std::uniform_int_distribution<std::uint32_t> dist(0, pq_list_size_ - 1);
+            typename Configuration::Backoff backoff{};
             do {
-                first_index = dist(thread_data_[handle.id_].gen);
-                second_index = dist(thread_data_[handle.id_].gen);
+                backoff();
+                thread_data_[handle.id_].sampler(first_index, second_index);
                 first_key = pq_list_[first_index].top_key.load(std::memory_order_relaxed);
                 second_key = pq_list_[second_index].top_key.load(std::memory_order_relaxed);
                 if (first_key == max_key && second_key == max_key) {
@@ -504,6 +513,9 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
         ss << "Abort on misalignment\n\t";
 #endif
+        if (Configuration::HeapBlockSize > 0) {
+            ss << "Heap storage in blocks of " << Configuration::HeapBlockSize << " elements\n\t";
+        }
         ss << "Preallocation for " << Configuration::ReservePerQueue << " elements per internal pq";
         return ss.str();
     }
@@ -511,4 +523,4 @@ class int_multiqueue_assigned : private int_multiqueue_assigned_base<Key, T> {
 
 }  // namespace multiqueue
 
-#endif  //! MULTIQUEUE_HPP_INCLUDED
+#endif  //! INT_MULTIQUEUE_ASSIGNED_HPP_INCLUDED
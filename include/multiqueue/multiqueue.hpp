@@ -12,6 +12,11 @@
 #define MULTIQUEUE_HPP_INCLUDED
 
 #include "multiqueue/configurations.hpp"
+#include "multiqueue/util/backoff.hpp"
+#include "multiqueue/util/numa.hpp"
+#include "multiqueue/util/parking.hpp"
+#include "multiqueue/util/random.hpp"
+#include "multiqueue/util/seqlock.hpp"
 #include "system_config.hpp"
 
 #ifdef MULTIQUEUE_HAVE_NUMA
@@ -20,10 +25,14 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <type_traits>
@@ -31,7 +40,13 @@
 
 namespace multiqueue {
 
-template <typename Key, typename T, typename Comparator>
+// Selects the constructor of a multiqueue whose handles are registered at runtime
+struct elastic_t {
+    explicit elastic_t() = default;
+};
+inline constexpr elastic_t elastic{};
+
+template <typename Key, typename T, typename Comparator, typename RandomEngine>
 struct multiqueue_base {
     using key_type = Key;
     using mapped_type = T;
@@ -54,15 +69,58 @@ struct multiqueue_base {
 
    protected:
     struct alignas(2 * L1_CACHE_LINESIZE) ThreadData {
-        std::mt19937 gen;
-        std::uniform_int_distribution<size_type> dist;
+        util::index_sampler<RandomEngine> sampler;
+        // Node the handle is bound to, if `num_numa_nodes` is not zero
+        unsigned int numa_node = 0;
+        unsigned int num_numa_nodes = 0;
         unsigned int insert_count = 0;
         std::array<unsigned int, 2> extract_count = {0, 0};
         size_type insert_index;
         std::array<size_type, 2> extract_index;
+        // Current stickiness if it is adapted at runtime, and the operations and sticky queue failures of the handle in
+        // the current period
+        unsigned int stickiness = 1;
+        unsigned int period_operations = 0;
+        unsigned int period_failures = 0;
+        // Odd while the handle is idle (see `try_terminate`), only written by the owning thread
+        std::atomic_uint64_t idle_epoch{0};
+        // Pushed elements not yet visible to other handles and the position of the smallest one
+        std::vector<value_type> staged;
+        size_type staged_min = 0;
+        // The `C` queues scanned by `extract_from_partition`, the rank of the handle among the registered handles
+        std::atomic_uint partition{0};
 
         inline size_type get_random_index() {
-            return dist(gen);
+            return sampler();
+        }
+
+        // Both indices come from a single draw
+        inline void get_random_indices(size_type &first, size_type &second) {
+            sampler(first, second);
+        }
+
+        template <std::size_t N>
+        inline void get_random_indices(std::array<size_type, N> &indices) {
+            for (std::size_t i = 0; i + 1 < N; i += 2) {
+                sampler(indices[i], indices[i + 1]);
+            }
+            if constexpr (N % 2 == 1) {
+                indices[N - 1] = sampler();
+            }
+        }
+
+        // Samples from [first, last) with probability 1 - `remote_probability` and from all queues otherwise
+        inline void set_local_range(size_type first, size_type last, double remote_probability) {
+            sampler.set_local_range(first, last, remote_probability);
+        }
+
+        // Must be called while holding the lock of the queue an element was extracted from, so that a termination
+        // sweep locking this queue afterwards observes the handle as busy
+        inline void mark_busy() noexcept {
+            auto const epoch = idle_epoch.load(std::memory_order_relaxed);
+            if (epoch % 2 == 1) {
+                idle_epoch.store(epoch + 1, std::memory_order_relaxed);
+            }
         }
     };
 
@@ -71,11 +129,10 @@ struct multiqueue_base {
 
     explicit multiqueue_base(unsigned int const num_threads, unsigned int const C, std::uint32_t seed) : comp_() {
         thread_data_ = new ThreadData[num_threads]();
-        auto params = typename std::uniform_int_distribution<size_type>::param_type{0, num_threads * C - 1};
         for (std::size_t i = 0; i < num_threads; ++i) {
             std::seed_seq seq{seed + i};
-            thread_data_[i].gen.seed(seq);
-            thread_data_[i].dist.param(params);
+            thread_data_[i].sampler.seed(seq);
+            thread_data_[i].sampler.set_size(num_threads * C);
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
             if (reinterpret_cast<std::uintptr_t>(&thread_data_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
                 std::abort();
@@ -88,11 +145,10 @@ struct multiqueue_base {
                              std::uint32_t seed)
         : comp_(comp) {
         thread_data_ = new ThreadData[num_threads]();
-        auto params = typename std::uniform_int_distribution<size_type>::param_type{0, num_threads * C - 1};
         for (std::size_t i = 0; i < num_threads; ++i) {
             std::seed_seq seq{seed + i};
-            thread_data_[i].gen.seed(seq);
-            thread_data_[i].dist.param(params);
+            thread_data_[i].sampler.seed(seq);
+            thread_data_[i].sampler.set_size(num_threads * C);
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
             if (reinterpret_cast<std::uintptr_t>(&thread_data_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
                 std::abort();
@@ -108,9 +164,14 @@ struct multiqueue_base {
 
 template <typename Key, typename T, typename Comparator = std::less<Key>,
           typename Configuration = configuration::Default, typename Allocator = std::allocator<Key>>
-class multiqueue : private multiqueue_base<Key, T, Comparator> {
+class multiqueue : private multiqueue_base<Key, T, Comparator, typename Configuration::RandomEngine> {
+    static_assert(Configuration::MinK >= 1 && Configuration::MinK <= Configuration::MaxK,
+                  "Stickiness bounds must satisfy 1 <= MinK <= MaxK");
+    static_assert(Configuration::ExtractSampleSize >= 1 && Configuration::InsertSampleSize >= 1,
+                  "At least one queue must be sampled");
+
    private:
-    using base_type = multiqueue_base<Key, T, Comparator>;
+    using base_type = multiqueue_base<Key, T, Comparator, typename Configuration::RandomEngine>;
 
    public:
     using allocator_type = Allocator;
@@ -136,9 +197,21 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
         using allocator_type = typename Configuration::HeapAllocator;
         static constexpr uint32_t lock_mask = static_cast<uint32_t>(1) << 31;
         static constexpr uint32_t pheromone_mask = lock_mask - 1;
+        // No handle has this id, so a retired queue is never regarded as locked by its owner
+        static constexpr uint32_t retired_mask = lock_mask | pheromone_mask;
         mutable std::atomic_uint32_t guard = Configuration::WithPheromones ? pheromone_mask : 0;
         pq_type pq;
 
+        struct TopSnapshot {
+            key_type key;
+            bool empty = true;
+        };
+        struct NoSnapshot {};
+        // Copy of the top key published on every unlock, so that queues can be compared without locking them
+        static constexpr bool use_top_snapshot = Configuration::WithTopSnapshot &&
+            std::is_trivially_copyable_v<key_type> && std::is_default_constructible_v<key_type>;
+        std::conditional_t<use_top_snapshot, util::seqlock<TopSnapshot>, NoSnapshot> top_snapshot;
+
         InternalPriorityQueueWrapper() = default;
 
         explicit InternalPriorityQueueWrapper(allocator_type const &alloc) : pq(alloc) {
@@ -148,6 +221,10 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
             : pq(comp, alloc) {
         }
 
+        inline bool is_locked() const noexcept {
+            return (guard.load(std::memory_order_relaxed) >> 31) == 1;
+        }
+
         inline bool try_lock(uint32_t id, bool claiming) const noexcept {
             uint32_t lock_status = guard.load(std::memory_order_relaxed);
             if ((lock_status >> 31) == 1) {
@@ -161,10 +238,34 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
                                                  std::memory_order_relaxed);
         }
 
-        inline void unlock(uint32_t id) const noexcept {
+        inline void unlock(uint32_t id) noexcept {
             assert(guard == (Configuration::WithPheromones ? (lock_mask | static_cast<uint32_t>(id)) : lock_mask));
+            if constexpr (use_top_snapshot) {
+                TopSnapshot snapshot;
+                snapshot.empty = !pq.peek_top_key(snapshot.key);
+                top_snapshot.store(snapshot);
+            }
             guard.store(Configuration::WithPheromones ? static_cast<uint32_t>(id) : 0, std::memory_order_release);
         }
+
+        // A retired queue stays locked, so threads still sampling it fail to lock it and resample. Must be called
+        // while holding the lock of the (empty) queue.
+        inline void retire() noexcept {
+            assert(pq.empty());
+            if constexpr (use_top_snapshot) {
+                top_snapshot.store(TopSnapshot{});
+            }
+            guard.store(retired_mask, std::memory_order_release);
+        }
+
+        inline void revive() noexcept {
+            assert(is_retired());
+            guard.store(Configuration::WithPheromones ? pheromone_mask : 0, std::memory_order_release);
+        }
+
+        inline bool is_retired() const noexcept {
+            return guard.load(std::memory_order_acquire) == retired_mask;
+        }
     };
 
     static_assert(std::is_same_v<value_type, typename InternalPriorityQueueWrapper::pq_type::heap_type::value_type>);
@@ -178,96 +279,373 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
     InternalPriorityQueueWrapper *pq_list_;
     size_type pq_list_size_;
     queue_alloc_type alloc_;
+    util::parking parking_;
+    alignas(L1_CACHE_LINESIZE) std::atomic_bool terminated_{false};
+    // Number of active local queues, which form a prefix of `pq_list_`
+    alignas(L1_CACHE_LINESIZE) std::atomic<size_type> num_queues_;
+    // Handle registration and resizing are rare and serialized
+    std::mutex registry_mutex_;
+    std::vector<bool> registered_;
+    unsigned int num_registered_;
 
    private:
-    inline void refresh_insert_index(Handle handle) {
-        thread_data_[handle.id_].insert_index = thread_data_[handle.id_].get_random_index();
-        thread_data_[handle.id_].insert_count = Configuration::K;
+    // Re-parameterises the index distribution of the handle if the number of active queues changed. Only the owning
+    // thread modifies its distribution, so this is called at the beginning of each operation.
+    inline void sync_queue_count(Handle handle) noexcept {
+        auto const num_queues = num_queues_.load(std::memory_order_acquire);
+        auto &sampler = thread_data_[handle.id_].sampler;
+        if (sampler.size() != num_queues) {
+            sampler.set_size(num_queues);
+            update_local_range(handle, num_queues);
+        }
     }
 
-    inline void refresh_extract_indices(Handle handle) {
-        thread_data_[handle.id_].extract_index[0] = thread_data_[handle.id_].get_random_index();
-        do {
-            thread_data_[handle.id_].extract_index[1] = thread_data_[handle.id_].get_random_index();
-        } while (thread_data_[handle.id_].extract_index[1] == thread_data_[handle.id_].extract_index[0]);
-        thread_data_[handle.id_].extract_count = Configuration::K;
+    // Queues are placed on the nodes in blocks of the full queue array, of which only the active prefix is sampled
+    inline void update_local_range(Handle handle, size_type num_queues) {
+        auto &data = thread_data_[handle.id_];
+        if (data.num_numa_nodes == 0) {
+            return;
+        }
+        auto const [first, last] = util::numa_local_range(pq_list_size_, data.numa_node, data.num_numa_nodes);
+        data.set_local_range(first, std::min(last, num_queues), Configuration::NumaRemoteProbability);
     }
 
-   public:
-    explicit multiqueue(unsigned int const num_threads, std::uint32_t seed = 0,
-                        allocator_type const &alloc = allocator_type())
-        : base_type{num_threads, Configuration::C, seed}, pq_list_size_{num_threads * Configuration::C}, alloc_(alloc) {
-        assert(num_threads >= 1);
-#ifdef MULTIQUEUE_HAVE_NUMA
-        if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_all_nodes_ptr);
+    // Collects the element in the staging buffer of the handle and moves the buffer into a local queue once it is full
+    void stage(Handle handle, value_type const &value) {
+        auto &data = thread_data_[handle.id_];
+        if (!data.staged.empty() && !comp_(value.first, data.staged[data.staged_min].first)) {
+            data.staged.push_back(value);
+        } else {
+            data.staged_min = data.staged.size();
+            data.staged.push_back(value);
+        }
+        if (data.staged.size() == Configuration::StagingBufferSize) {
+            flush_staged(handle);
+        }
+    }
+
+    // Moves all staged elements of the handle into one random local queue
+    void flush_staged(Handle handle) {
+        auto &data = thread_data_[handle.id_];
+        if (data.staged.empty()) {
+            return;
+        }
+        size_type index = sample_insert_queue(handle);
+        typename Configuration::Backoff backoff{};
+        while (!pq_list_[index].try_lock(handle.id_, true)) {
+            backoff();
+            index = sample_insert_queue(handle);
+        }
+        pq_list_[index].pq.push_batch(data.staged.begin(), data.staged.end());
+        data.staged.clear();
+        pq_list_[index].unlock(handle.id_);
+        parking_.notify();
+    }
+
+    // Must be called while holding the lock of queue `index`, which is empty if `queue_empty` is set. Moves the staged
+    // elements of the handle into this queue if the smallest staged element would be extracted before its top.
+    // Returns false if the queue is still empty.
+    bool merge_staged(Handle handle, size_type index, bool queue_empty) {
+        auto &data = thread_data_[handle.id_];
+        if (Configuration::StagingBufferSize == 0 || data.staged.empty()) {
+            return !queue_empty;
+        }
+        if (queue_empty || comp_(data.staged[data.staged_min].first, pq_list_[index].pq.top().first)) {
+            pq_list_[index].pq.push_batch(data.staged.begin(), data.staged.end());
+            data.staged.clear();
+            pq_list_[index].pq.refresh_top();
+        }
+        return true;
+    }
+
+    // Locks a random local queue and moves the staged elements of the handle into it. Returns false if nothing is
+    // staged, in which case no queue is locked.
+    bool lock_staged_queue(Handle handle, size_type &index) {
+        if (Configuration::StagingBufferSize == 0 || thread_data_[handle.id_].staged.empty()) {
+            return false;
         }
+        index = thread_data_[handle.id_].get_random_index();
+        typename Configuration::Backoff backoff{};
+        while (!pq_list_[index].try_lock(handle.id_, true)) {
+            backoff();
+            index = thread_data_[handle.id_].get_random_index();
+        }
+        return merge_staged(handle, index, !pq_list_[index].pq.refresh_top());
+    }
+
+    // Selects a local queue to extract from as `lock_top_queue`, but also considers the staged elements of the handle
+    bool lock_extract_queue(Handle handle, size_type &index) {
+        if (lock_top_queue(handle, index)) {
+            return merge_staged(handle, index, false);
+        }
+        return lock_staged_queue(handle, index);
+    }
+
+    // Activates or retires queues so that `C` queues are active per registered handle (at least `C`). Elements of
+    // retired queues are moved into the surviving queues. Must be called while holding `registry_mutex_`.
+    void resize(Handle handle) {
+        auto const old_num_queues = num_queues_.load(std::memory_order_relaxed);
+        auto const new_num_queues = std::max(num_registered_, 1U) * static_cast<size_type>(Configuration::C);
+        if (new_num_queues > old_num_queues) {
+            for (size_type i = old_num_queues; i < new_num_queues; ++i) {
+                pq_list_[i].revive();
+            }
+            num_queues_.store(new_num_queues, std::memory_order_release);
+            return;
+        }
+        if (new_num_queues == old_num_queues) {
+            return;
+        }
+        // Publish the smaller count first, so that the retired queues are sampled as rarely as possible
+        num_queues_.store(new_num_queues, std::memory_order_release);
+        sync_queue_count(handle);
+        typename Configuration::Backoff backoff{};
+        value_type tmp;
+        for (size_type i = new_num_queues; i < old_num_queues; ++i) {
+            while (!pq_list_[i].try_lock(handle.id_, true)) {
+                backoff();
+            }
+            while (pq_list_[i].pq.refresh_top()) {
+                pq_list_[i].pq.extract_top(tmp);
+                size_type index = thread_data_[handle.id_].get_random_index();
+                while (!pq_list_[index].try_lock(handle.id_, true)) {
+                    backoff();
+                    index = thread_data_[handle.id_].get_random_index();
+                }
+                pq_list_[index].pq.push(tmp);
+                pq_list_[index].unlock(handle.id_);
+            }
+            pq_list_[i].retire();
+        }
+        parking_.notify();
+    }
+
+    // Assigns the registered handles the partitions of the active queues in the order of their ids. Must be called
+    // while holding `registry_mutex_` and while all assigned partitions are active.
+    void update_partitions() noexcept {
+        unsigned int rank = 0;
+        for (unsigned int i = 0; i < registered_.size(); ++i) {
+            if (registered_[i]) {
+                thread_data_[i].partition.store(rank++, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // A sticky queue of the handle was locked by another thread or empty
+    inline void count_sticky_failure(Handle handle) noexcept {
+        if constexpr (Configuration::AdaptiveK) {
+            ++thread_data_[handle.id_].period_failures;
+        }
+    }
+
+    // Ends an operation of the handle. The stickiness is adapted once per period of `stickiness` operations: halved
+    // if a sticky queue failed during the period and doubled otherwise.
+    inline void count_sticky_operation(Handle handle) noexcept {
+        if constexpr (Configuration::AdaptiveK) {
+            auto &data = thread_data_[handle.id_];
+            if (++data.period_operations < data.stickiness) {
+                return;
+            }
+            data.stickiness = data.period_failures == 0 ? std::min(Configuration::MaxK, 2 * data.stickiness)
+                                                        : std::max(Configuration::MinK, data.stickiness / 2);
+            data.period_operations = 0;
+            data.period_failures = 0;
+        }
+    }
+
+    // Samples `ExtractSampleSize` local queues by their snapshots and selects the one with the smallest top key.
+    // Returns false if all sampled queues appear empty.
+    bool sample_top_queue(Handle handle, size_type &index) {
+        std::array<size_type, Configuration::ExtractSampleSize> indices;
+        thread_data_[handle.id_].get_random_indices(indices);
+        if constexpr (Configuration::ExtractSampleSize > 2) {
+            for (auto i : indices) {
+                __builtin_prefetch(&pq_list_[i].top_snapshot);
+            }
+        }
+        index = indices[0];
+        auto best = pq_list_[indices[0]].top_snapshot.load();
+        for (std::size_t i = 1; i < indices.size(); ++i) {
+            auto const snapshot = pq_list_[indices[i]].top_snapshot.load();
+            if (best.empty || (!snapshot.empty && comp_(snapshot.key, best.key))) {
+                index = indices[i];
+                best = snapshot;
+            }
+        }
+        return !best.empty;
+    }
+
+    // Samples `InsertSampleSize` local queues and selects an unlocked one, preferring the largest top key if top
+    // snapshots are available, as queues holding few elements tend to have large top keys. Falls back to the first
+    // sampled queue if all of them are locked.
+    size_type sample_insert_queue(Handle handle) {
+        if constexpr (Configuration::InsertSampleSize == 1) {
+            return thread_data_[handle.id_].get_random_index();
+        } else {
+            std::array<size_type, Configuration::InsertSampleSize> indices;
+            thread_data_[handle.id_].get_random_indices(indices);
+            for (auto i : indices) {
+                __builtin_prefetch(&pq_list_[i].guard);
+                if constexpr (InternalPriorityQueueWrapper::use_top_snapshot) {
+                    __builtin_prefetch(&pq_list_[i].top_snapshot);
+                }
+            }
+            if constexpr (!InternalPriorityQueueWrapper::use_top_snapshot) {
+                for (auto i : indices) {
+                    if (!pq_list_[i].is_locked()) {
+                        return i;
+                    }
+                }
+                return indices[0];
+            } else {
+                size_type index = indices[0];
+                bool found = false;
+                typename InternalPriorityQueueWrapper::TopSnapshot largest;
+                for (auto i : indices) {
+                    if (pq_list_[i].is_locked()) {
+                        continue;
+                    }
+                    auto const snapshot = pq_list_[i].top_snapshot.load();
+                    if (!found || (!largest.empty && (snapshot.empty || comp_(largest.key, snapshot.key)))) {
+                        index = i;
+                        largest = snapshot;
+                        found = true;
+                    }
+                }
+                return index;
+            }
+        }
+    }
+
+    // Selects a local queue by `sample_top_queue` if top snapshots are available and otherwise locks two sampled
+    // queues to compare them. Keeps the selected queue locked and returns false if the sampled queues are empty, in
+    // which case no queue remains locked.
+    bool lock_top_queue(Handle handle, size_type &index) {
+        if constexpr (InternalPriorityQueueWrapper::use_top_snapshot) {
+            // Only the queue with the smallest snapshot is locked
+            typename Configuration::Backoff backoff{};
+            while (true) {
+                size_type first_index;
+                if (!sample_top_queue(handle, first_index)) {
+                    return false;
+                }
+                if (pq_list_[first_index].try_lock(handle.id_, true)) {
+                    if (pq_list_[first_index].pq.refresh_top()) {
+                        index = first_index;
+                        return true;
+                    }
+                    // The queue was emptied after we read the snapshot
+                    pq_list_[first_index].unlock(handle.id_);
+                }
+                backoff();
+            }
+        }
+        size_type first_index;
+        size_type second_index;
+        thread_data_[handle.id_].get_random_indices(first_index, second_index);
+        typename Configuration::Backoff backoff{};
+
+        while (!pq_list_[first_index].try_lock(handle.id_, true)) {
+            backoff();
+            first_index = thread_data_[handle.id_].get_random_index();
+        }
+        bool first_empty = !pq_list_[first_index].pq.refresh_top();
+        if (first_empty) {
+            pq_list_[first_index].unlock(handle.id_);
+        }
+
+        while (!pq_list_[second_index].try_lock(handle.id_, true)) {
+            backoff();
+            second_index = thread_data_[handle.id_].get_random_index();
+        }
+        bool second_empty = !pq_list_[second_index].pq.refresh_top();
+        if (second_empty) {
+            pq_list_[second_index].unlock(handle.id_);
+        }
+        count_sticky_operation(handle);
+
+        // We now have selected two queues, which might be empty
+
+        if (first_empty && second_empty) {
+            return false;
+        }
+
+        if (!first_empty && !second_empty) {
+            if (comp_(pq_list_[second_index].pq.top().first, pq_list_[first_index].pq.top().first)) {
+                std::swap(first_index, second_index);
+            }
+            pq_list_[second_index].unlock(handle.id_);
+        } else if (first_empty) {
+            first_index = second_index;
+        }
+        index = first_index;
+        return true;
+    }
+
+    void init_queues(unsigned int const num_threads) {
+        for (unsigned int i = 0; i < num_threads; ++i) {
+            thread_data_[i].stickiness = std::clamp(Configuration::K, Configuration::MinK, Configuration::MaxK);
+            thread_data_[i].staged.reserve(Configuration::StagingBufferSize);
+            thread_data_[i].partition.store(i, std::memory_order_relaxed);
+        }
+        {
+            // Only the queue array is interleaved, the heaps are placed by first touch
+#ifdef MULTIQUEUE_HAVE_NUMA
+            util::interleave_scope interleave{Configuration::NumaFriendly};
 #endif
-        pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
-        for (std::size_t i = 0; i < pq_list_size_; ++i) {
-            alloc_traits::construct(alloc_, pq_list_ + i);
+            pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
+            for (std::size_t i = 0; i < pq_list_size_; ++i) {
+                alloc_traits::construct(alloc_, pq_list_ + i, comp_);
 #ifdef MULTIQUEUE_ABORT_MISALIGNED
-            if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
-                std::abort();
-            }
+                if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
+                    std::abort();
+                }
 #endif
+            }
         }
+        reserve_queues(Configuration::ReservePerQueue);
+    }
+
+    // Reserves space for `per_queue` elements in each local queue. Numa friendly queues are touched in parallel by
+    // one worker per handle, each running on the node its queues are placed on. Otherwise, only address space is
+    // reserved and the pages are populated by the threads pushing into the queues.
+    void reserve_queues(std::size_t const per_queue) {
 #ifdef MULTIQUEUE_HAVE_NUMA
         if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_no_nodes_ptr);
+            util::parallel_first_touch(
+                pq_list_size_, static_cast<unsigned int>(pq_list_size_ / Configuration::C),
+                [this, per_queue](std::size_t i) { pq_list_[i].pq.heap.reserve_and_touch(per_queue); });
+            return;
         }
 #endif
         for (std::size_t i = 0; i < pq_list_size_; ++i) {
-#ifdef MULTIQUEUE_HAVE_NUMA
-            if (Configuration::NumaFriendly) {
-                numa_set_preferred(
-                    static_cast<int>(i / (pq_list_size_ / (static_cast<std::size_t>(numa_max_node()) + 1))));
-                pq_list_[i].pq.heap.reserve_and_touch(Configuration::ReservePerQueue);
-                numa_set_preferred(-1);
-            }
-#else
-            pq_list_[i].pq.heap.reserve(Configuration::ReservePerQueue);
-#endif
+            pq_list_[i].pq.heap.reserve(per_queue);
         }
     }
 
+   public:
+    explicit multiqueue(unsigned int const num_threads, std::uint32_t seed = 0,
+                        allocator_type const &alloc = allocator_type())
+        : base_type{num_threads, Configuration::C, seed},
+          pq_list_size_{num_threads * Configuration::C},
+          alloc_(alloc),
+          num_queues_{pq_list_size_},
+          registered_(num_threads, true),
+          num_registered_{num_threads} {
+        assert(num_threads >= 1);
+        init_queues(num_threads);
+    }
+
     explicit multiqueue(unsigned int const num_threads, key_comparator const &comp, std::uint32_t seed = 0,
                         allocator_type const &alloc = allocator_type())
         : base_type{num_threads, Configuration::C, comp, seed},
           pq_list_size_{num_threads * Configuration::C},
-          alloc_(alloc) {
+          alloc_(alloc),
+          num_queues_{pq_list_size_},
+          registered_(num_threads, true),
+          num_registered_{num_threads} {
         assert(num_threads >= 1);
-#ifdef MULTIQUEUE_HAVE_NUMA
-        if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_all_nodes_ptr);
-        }
-#endif
-        pq_list_ = std::allocator_traits<allocator_type>::allocate(alloc_, pq_list_size_);
-        for (std::size_t i = 0; i < pq_list_size_; ++i) {
-            std::allocator_traits<allocator_type>::construct(alloc_, pq_list_ + i, comp);
-#ifdef MULTIQUEUE_ABORT_MISALIGNED
-            if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
-                std::abort();
-            }
-#endif
-        }
-#ifdef MULTIQUEUE_HAVE_NUMA
-        if (Configuration::NumaFriendly) {
-            numa_set_interleave_mask(numa_no_nodes_ptr);
-        }
-#endif
-        for (std::size_t i = 0; i < pq_list_.size(); ++i) {
-#ifdef MULTIQUEUE_HAVE_NUMA
-            if (Configuration::NumaFriendly) {
-                numa_set_preferred(
-                    static_cast<int>(i / (pq_list_.size() / (static_cast<std::size_t>(numa_max_node()) + 1))));
-                pq_list_[i].pq.heap.reserve_and_touch(Configuration::ReservePerQueue);
-                numa_set_preferred(-1);
-            }
-#else
-            pq_list_[i].pq.heap.reserve(Configuration::ReservePerQueue);
-#endif
-        }
+        init_queues(num_threads);
     }
 
     ~multiqueue() noexcept {
@@ -277,153 +655,381 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
         alloc_traits::deallocate(alloc_, pq_list_, pq_list_size_);
     }
 
+    // Creates a multiqueue for at most `max_threads` handles without any registered handle. Handles are obtained with
+    // `register_handle` and returned with `release_handle`, and the number of active local queues follows the number
+    // of registered handles.
+    multiqueue(elastic_t, unsigned int const max_threads, std::uint32_t seed = 0,
+               allocator_type const &alloc = allocator_type())
+        : multiqueue(max_threads, seed, alloc) {
+        registered_.assign(max_threads, false);
+        num_registered_ = 0;
+        for (unsigned int i = 0; i < max_threads; ++i) {
+            // Unregistered handles count as idle for termination detection
+            thread_data_[i].idle_epoch.store(1, std::memory_order_relaxed);
+        }
+        for (size_type i = Configuration::C; i < pq_list_size_; ++i) {
+            pq_list_[i].retire();
+        }
+        num_queues_.store(Configuration::C, std::memory_order_relaxed);
+    }
+
+    // Reserves space for `expected_size` elements in total, split evenly over all local queues. Must not be called
+    // concurrently with other operations.
+    void reserve(size_type const expected_size) {
+        reserve_queues((expected_size + pq_list_size_ - 1) / pq_list_size_);
+    }
+
+    // Only valid if the multiqueue was not created as elastic
     static Handle get_handle(unsigned int id) noexcept {
         return Handle{id};
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1), int> = 0>
+    // Binds the handle to `node` out of `num_nodes` numa nodes, so that it mostly samples the queues placed on this
+    // node. Should be called by the thread owning the handle. Also usable to emulate numa nodes without numa support.
+    void set_numa_node(Handle handle, unsigned int node, unsigned int num_nodes) {
+        thread_data_[handle.id_].numa_node = node;
+        thread_data_[handle.id_].num_numa_nodes = num_nodes;
+        update_local_range(handle, num_queues_.load(std::memory_order_acquire));
+    }
+
+    // Binds the handle to the numa node of the cpu the calling thread runs on, which should be pinned
+    void set_numa_node(Handle handle) {
+        set_numa_node(handle, util::current_numa_node(), util::numa_node_count());
+    }
+
+    // Returns an unused handle and activates `C` more local queues, or nothing if all handles are registered
+    std::optional<Handle> register_handle() {
+        std::lock_guard<std::mutex> lock{registry_mutex_};
+        auto it = std::find(registered_.begin(), registered_.end(), false);
+        if (it == registered_.end()) {
+            return std::nullopt;
+        }
+        *it = true;
+        ++num_registered_;
+        Handle handle{static_cast<unsigned int>(it - registered_.begin())};
+        auto &data = thread_data_[handle.id_];
+        data.insert_count = 0;
+        data.extract_count = {0, 0};
+        data.stickiness = std::clamp(Configuration::K, Configuration::MinK, Configuration::MaxK);
+        data.period_operations = 0;
+        data.period_failures = 0;
+        data.num_numa_nodes = 0;
+        data.sampler.set_local_range(0, 0, 1.0);
+        // A registered handle may push, so it starts busy
+        auto const epoch = data.idle_epoch.load(std::memory_order_relaxed);
+        data.idle_epoch.store(epoch + (epoch % 2 == 1 ? 1 : 2), std::memory_order_seq_cst);
+        resize(handle);
+        update_partitions();
+        return handle;
+    }
+
+    // Retires `C` local queues and moves their elements into the remaining queues. Must be called by the thread owning
+    // `handle`, which must not be used afterwards.
+    void release_handle(Handle handle) {
+        flush_staged(handle);
+        std::lock_guard<std::mutex> lock{registry_mutex_};
+        assert(registered_[handle.id_]);
+        registered_[handle.id_] = false;
+        --num_registered_;
+        // The partitions move out of the queues to retire first
+        update_partitions();
+        resize(handle);
+        // Only marked idle after the elements were moved, see `try_terminate`
+        auto &epoch = thread_data_[handle.id_].idle_epoch;
+        auto const e = epoch.load(std::memory_order_relaxed);
+        epoch.store(e + (e % 2 == 1 ? 2 : 1), std::memory_order_seq_cst);
+    }
+
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1 && !Configuration::AdaptiveK), int> = 0>
     void push(Handle handle, value_type const &value) {
-        size_type index = thread_data_[handle.id_].get_random_index();
+        sync_queue_count(handle);
+        if constexpr (Configuration::StagingBufferSize > 0) {
+            stage(handle, value);
+            return;
+        }
+        size_type index = sample_insert_queue(handle);
+        typename Configuration::Backoff backoff{};
         while (!pq_list_[index].try_lock(handle.id_, true)) {
-            index = thread_data_[handle.id_].get_random_index();
+            backoff();
+            index = sample_insert_queue(handle);
         }
         pq_list_[index].pq.push(value);
         pq_list_[index].unlock(handle.id_);
+        parking_.notify();
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1), int> = 0>
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1 || Configuration::AdaptiveK), int> = 0>
     void push(Handle handle, value_type const &value) {
+        sync_queue_count(handle);
+        if constexpr (Configuration::StagingBufferSize > 0) {
+            stage(handle, value);
+            return;
+        }
         if (thread_data_[handle.id_].insert_count == 0) {
-            thread_data_[handle.id_].insert_index = thread_data_[handle.id_].get_random_index();
-            thread_data_[handle.id_].insert_count = Configuration::K;
+            thread_data_[handle.id_].insert_index = sample_insert_queue(handle);
+            thread_data_[handle.id_].insert_count = stickiness(handle);
         }
         size_type index = thread_data_[handle.id_].insert_index;
         if (!pq_list_[index].try_lock(
                 handle.id_,
-                !Configuration::WithPheromones || thread_data_[handle.id_].insert_count == Configuration::K)) {
+                !Configuration::WithPheromones || thread_data_[handle.id_].insert_count == stickiness(handle))) {
+            count_sticky_failure(handle);
+            typename Configuration::Backoff backoff{};
             do {
-                index = thread_data_[handle.id_].get_random_index();
+                backoff();
+                index = sample_insert_queue(handle);
             } while (!pq_list_[index].try_lock(handle.id_, true));
             thread_data_[handle.id_].insert_index = index;
-            thread_data_[handle.id_].insert_count = Configuration::K;
+            thread_data_[handle.id_].insert_count = stickiness(handle);
         }
         pq_list_[index].pq.push(value);
         pq_list_[index].unlock(handle.id_);
+        parking_.notify();
         --thread_data_[handle.id_].insert_count;
+        count_sticky_operation(handle);
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1), int> = 0>
-    bool extract_top(Handle handle, value_type &retval) {
-        size_type first_index = thread_data_[handle.id_].get_random_index();
-        size_type second_index = thread_data_[handle.id_].get_random_index();
-
-        while (!pq_list_[first_index].try_lock(handle.id_, true)) {
-            first_index = thread_data_[handle.id_].get_random_index();
-        }
-        bool first_empty = !pq_list_[first_index].pq.refresh_top();
-        if (first_empty) {
-            pq_list_[first_index].unlock(handle.id_);
-        }
+    // Makes all elements staged by the handle visible to other handles
+    void flush(Handle handle) {
+        sync_queue_count(handle);
+        flush_staged(handle);
+    }
 
-        while (!pq_list_[second_index].try_lock(handle.id_, true)) {
-            second_index = thread_data_[handle.id_].get_random_index();
+    // Inserts all elements in [first, last) into one randomly chosen local queue, which is locked only once. Since
+    // the whole batch ends up in the same queue, very large batches increase the rank error of later deletions.
+    template <typename InputIt>
+    void push_batch(Handle handle, InputIt first, InputIt last) {
+        sync_queue_count(handle);
+        if (first == last) {
+            return;
         }
-        bool second_empty = !pq_list_[second_index].pq.refresh_top();
-        if (second_empty) {
-            pq_list_[second_index].unlock(handle.id_);
+        size_type index = sample_insert_queue(handle);
+        typename Configuration::Backoff backoff{};
+        while (!pq_list_[index].try_lock(handle.id_, true)) {
+            backoff();
+            index = sample_insert_queue(handle);
         }
+        pq_list_[index].pq.push_batch(first, last);
+        pq_list_[index].unlock(handle.id_);
+        parking_.notify();
+    }
 
-        // We now have selected two queues, which might be empty
-
-        if (first_empty && second_empty) {
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K == 1 && !Configuration::AdaptiveK), int> = 0>
+    bool extract_top(Handle handle, value_type &retval) {
+        sync_queue_count(handle);
+        size_type index;
+        if (!lock_extract_queue(handle, index)) {
             return false;
         }
-
-        if (!first_empty && !second_empty) {
-            if (comp_(pq_list_[second_index].pq.top().first, pq_list_[first_index].pq.top().first)) {
-                std::swap(first_index, second_index);
-            }
-            pq_list_[second_index].unlock(handle.id_);
-        } else if (first_empty) {
-            first_index = second_index;
-        }
-        pq_list_[first_index].pq.extract_top(retval);
-        pq_list_[first_index].unlock(handle.id_);
+        pq_list_[index].pq.extract_top(retval);
+        thread_data_[handle.id_].mark_busy();
+        pq_list_[index].unlock(handle.id_);
         return true;
     }
 
-    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1), int> = 0>
+    template <unsigned int K = Configuration::K, std::enable_if_t<(K > 1 || Configuration::AdaptiveK), int> = 0>
     bool extract_top(Handle handle, value_type &retval) {
+        sync_queue_count(handle);
         if (thread_data_[handle.id_].extract_count[0] == 0) {
             thread_data_[handle.id_].extract_index[0] = thread_data_[handle.id_].get_random_index();
-            thread_data_[handle.id_].extract_count[0] = Configuration::K;
+            thread_data_[handle.id_].extract_count[0] = stickiness(handle);
         }
         if (thread_data_[handle.id_].extract_count[1] == 0) {
             thread_data_[handle.id_].extract_index[1] = thread_data_[handle.id_].get_random_index();
-            thread_data_[handle.id_].extract_count[1] = Configuration::K;
+            thread_data_[handle.id_].extract_count[1] = stickiness(handle);
         }
         size_type first_index = thread_data_[handle.id_].extract_index[0];
         size_type second_index = thread_data_[handle.id_].extract_index[1];
 
+        typename Configuration::Backoff backoff{};
         if (!pq_list_[first_index].try_lock(handle.id_,
-                                            thread_data_[handle.id_].extract_count[0] == Configuration::K)) {
+                                            thread_data_[handle.id_].extract_count[0] == stickiness(handle))) {
+            count_sticky_failure(handle);
             do {
+                backoff();
                 first_index = thread_data_[handle.id_].get_random_index();
             } while (!pq_list_[first_index].try_lock(handle.id_, true));
             thread_data_[handle.id_].extract_index[0] = first_index;
-            thread_data_[handle.id_].extract_count[0] = Configuration::K;
+            thread_data_[handle.id_].extract_count[0] = stickiness(handle);
         }
         bool first_empty = !pq_list_[first_index].pq.refresh_top();
         if (first_empty) {
             pq_list_[first_index].unlock(handle.id_);
             thread_data_[handle.id_].extract_count[0] = 0;
+            count_sticky_failure(handle);
         } else {
             --thread_data_[handle.id_].extract_count[0];
         }
 
         if (!pq_list_[second_index].try_lock(
                 handle.id_,
-                !Configuration::WithPheromones || thread_data_[handle.id_].extract_count[1] == Configuration::K)) {
+                !Configuration::WithPheromones || thread_data_[handle.id_].extract_count[1] == stickiness(handle))) {
+            count_sticky_failure(handle);
             do {
+                backoff();
                 second_index = thread_data_[handle.id_].get_random_index();
             } while (!pq_list_[second_index].try_lock(handle.id_, true));
             thread_data_[handle.id_].extract_index[1] = second_index;
-            thread_data_[handle.id_].extract_count[1] = Configuration::K;
+            thread_data_[handle.id_].extract_count[1] = stickiness(handle);
         }
         bool second_empty = !pq_list_[second_index].pq.refresh_top();
         if (second_empty) {
             pq_list_[second_index].unlock(handle.id_);
             thread_data_[handle.id_].extract_count[1] = 0;
+            count_sticky_failure(handle);
         } else {
             --thread_data_[handle.id_].extract_count[1];
         }
+        count_sticky_operation(handle);
 
         // We now have selected two queues, which might be empty
 
         if (first_empty && second_empty) {
-            return false;
-        }
-
-        if (!first_empty && !second_empty) {
-            if (comp_(pq_list_[second_index].pq.top().first, pq_list_[first_index].pq.top().first)) {
-                std::swap(first_index, second_index);
+            if (!lock_staged_queue(handle, first_index)) {
+                return false;
             }
-            pq_list_[second_index].unlock(handle.id_);
-        } else if (first_empty) {
-            first_index = second_index;
+        } else {
+            if (!first_empty && !second_empty) {
+                if (comp_(pq_list_[second_index].pq.top().first, pq_list_[first_index].pq.top().first)) {
+                    std::swap(first_index, second_index);
+                }
+                pq_list_[second_index].unlock(handle.id_);
+            } else if (first_empty) {
+                first_index = second_index;
+            }
+            merge_staged(handle, first_index, false);
         }
         pq_list_[first_index].pq.extract_top(retval);
+        thread_data_[handle.id_].mark_busy();
         pq_list_[first_index].unlock(handle.id_);
         return true;
     }
 
+    // Extracts up to `n` elements from the local queue selected as in `extract_top` while holding its lock only once.
+    // The elements are written to `out` in ascending order and the number of extracted elements is returned.
+    template <typename OutputIt>
+    size_type extract_batch(Handle handle, OutputIt out, size_type n) {
+        sync_queue_count(handle);
+        size_type index;
+        if (n == 0 || !lock_extract_queue(handle, index)) {
+            return 0;
+        }
+        size_type count = 0;
+        value_type tmp;
+        do {
+            pq_list_[index].pq.extract_top(tmp);
+            *out = std::move(tmp);
+            ++out;
+            ++count;
+        } while (count < n && pq_list_[index].pq.refresh_top());
+        thread_data_[handle.id_].mark_busy();
+        pq_list_[index].unlock(handle.id_);
+        return count;
+    }
+
+    // Like `extract_top`, but if no element is found after `Configuration::WaitSpins` attempts, the thread sleeps until
+    // an element is pushed or `timeout` elapsed. Returns false only on timeout.
+    template <typename Rep, typename Period>
+    bool extract_top_wait(Handle handle, value_type &retval, std::chrono::duration<Rep, Period> const &timeout) {
+        for (unsigned int i = 0; i < Configuration::WaitSpins; ++i) {
+            if (extract_top(handle, retval)) {
+                return true;
+            }
+            util::cpu_relax();
+        }
+        auto const deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            auto const epoch = parking_.prepare_park();
+            // Re-check after announcing ourselves, as the element could have been pushed in between
+            if (extract_top(handle, retval)) {
+                parking_.cancel_park();
+                return true;
+            }
+            auto const now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                parking_.cancel_park();
+                return false;
+            }
+            parking_.park(epoch, deadline - now);
+            if (extract_top(handle, retval)) {
+                return true;
+            }
+        }
+    }
+
+    // Marks the handle as idle until its next successful extraction and returns true if all handles are idle and all
+    // queues are empty. A handle must not push while idle, so once this returns true, the computation has terminated
+    // and all subsequent calls return true as well. Intended to be called by workers after `extract_top` failed.
+    bool try_terminate(Handle handle) {
+        if (terminated_.load(std::memory_order_acquire)) {
+            return true;
+        }
+        if (!thread_data_[handle.id_].staged.empty()) {
+            flush_staged(handle);
+            return false;
+        }
+        auto &own_epoch = thread_data_[handle.id_].idle_epoch;
+        auto const epoch = own_epoch.load(std::memory_order_relaxed);
+        if (epoch % 2 == 0) {
+            own_epoch.store(epoch + 1, std::memory_order_seq_cst);
+        }
+        size_type const num_threads = pq_list_size_ / Configuration::C;
+        // Epochs never decrease, so an unchanged sum means that no handle became busy in between
+        std::uint64_t epoch_sum = 0;
+        for (size_type i = 0; i < num_threads; ++i) {
+            auto const e = thread_data_[i].idle_epoch.load(std::memory_order_seq_cst);
+            if (e % 2 == 0) {
+                return false;
+            }
+            epoch_sum += e;
+        }
+        typename Configuration::Backoff backoff{};
+        auto const num_queues = num_queues_.load(std::memory_order_acquire);
+        for (size_type i = 0; i < num_queues; ++i) {
+            while (!pq_list_[i].try_lock(handle.id_, true)) {
+                // Elements may have been moved into queues that were already checked
+                if (pq_list_[i].is_retired()) {
+                    return false;
+                }
+                backoff();
+            }
+            bool const empty = pq_list_[i].pq.empty();
+            pq_list_[i].unlock(handle.id_);
+            if (!empty) {
+                return false;
+            }
+        }
+        for (size_type i = 0; i < num_threads; ++i) {
+            epoch_sum -= thread_data_[i].idle_epoch.load(std::memory_order_seq_cst);
+        }
+        if (epoch_sum != 0) {
+            return false;
+        }
+        terminated_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Current stickiness of the handle, which is adapted at runtime if `Configuration::AdaptiveK` is set. Should only
+    // be called by the thread owning the handle.
+    inline unsigned int stickiness(Handle handle) const noexcept {
+        if constexpr (Configuration::AdaptiveK) {
+            return thread_data_[handle.id_].stickiness;
+        } else {
+            return Configuration::K;
+        }
+    }
+
+    // Extracts from the `C` queues of the handle's partition. With an elastic multiqueue, the partition is the rank of
+    // the handle among the registered handles and can change when other handles register or are released.
     bool extract_from_partition(Handle handle, value_type &retval) {
-        for (size_type i = Configuration::C * handle.id_; i < Configuration::C * (handle.id_ + 1); ++i) {
+        size_type const partition = thread_data_[handle.id_].partition.load(std::memory_order_relaxed);
+        for (size_type i = Configuration::C * partition; i < Configuration::C * (partition + 1); ++i) {
             if (!pq_list_[i].try_lock(handle.id_, true)) {
                 continue;
             }
             if (pq_list_[i].pq.refresh_top()) {
                 pq_list_[i].pq.extract_top(retval);
+                thread_data_[handle.id_].mark_busy();
                 pq_list_[i].unlock(handle.id_);
                 return true;
             }
@@ -436,7 +1042,12 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
         std::stringstream ss;
         ss << "multiqueue\n\t";
         ss << "C: " << Configuration::C << "\n\t";
-        ss << "K: " << Configuration::K << "\n\t";
+        if (Configuration::AdaptiveK) {
+            ss << "K: adaptive in [" << Configuration::MinK << ", " << Configuration::MaxK << "], starting at "
+               << Configuration::K << "\n\t";
+        } else {
+            ss << "K: " << Configuration::K << "\n\t";
+        }
         if (Configuration::UseMergeHeap) {
             ss << "Using merge heap, node size: " << Configuration::NodeSize << "\n\t";
         } else {
@@ -449,7 +1060,7 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
             ss << "Heap degree: " << Configuration::HeapDegree << "\n\t";
         }
         if (Configuration::NumaFriendly) {
-            ss << "Numa friendly\n\t";
+            ss << "Numa friendly, remote probability: " << Configuration::NumaRemoteProbability << "\n\t";
 #ifndef MULTIQUEUE_HAVE_NUMA
             ss << "But numasupport disabled!\n\t";
 #endif
@@ -460,6 +1071,19 @@ class multiqueue : private multiqueue_base<Key, T, Comparator> {
         if (Configuration::WithPheromones) {
             ss << "Using pheromones\n\t";
         }
+        if (InternalPriorityQueueWrapper::use_top_snapshot) {
+            ss << "Comparing top key snapshots without locking\n\t";
+            ss << "Sampling " << Configuration::ExtractSampleSize << " queues per extraction and "
+               << Configuration::InsertSampleSize << " per insertion\n\t";
+        } else {
+            ss << "Sampling 2 queues per extraction and " << Configuration::InsertSampleSize << " per insertion\n\t";
+        }
+        if (Configuration::StagingBufferSize > 0) {
+            ss << "Staging up to " << Configuration::StagingBufferSize << " pushes per handle\n\t";
+        }
+        if (Configuration::HeapBlockSize > 0) {
+            ss << "Heap storage in blocks of " << Configuration::HeapBlockSize << " elements\n\t";
+        }
         ss << "Preallocation for " << Configuration::ReservePerQueue << " elements per internal pq";
         return ss.str();
     }
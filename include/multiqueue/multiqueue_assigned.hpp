@@ -0,0 +1,341 @@
+/**
+******************************************************************************
+* @file:   multiqueue_assigned.hpp
+*
+* @brief:  Multiqueue with arbitrary comparators whose handles own the queues they use
+*******************************************************************************
+**/
+#pragma once
+#ifndef MULTIQUEUE_ASSIGNED_HPP_INCLUDED
+#define MULTIQUEUE_ASSIGNED_HPP_INCLUDED
+
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/backoff.hpp"
+#include "multiqueue/util/numa.hpp"
+#include "system_config.hpp"
+
+#ifdef MULTIQUEUE_HAVE_NUMA
+#include <numa.h>
+#endif
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace multiqueue {
+
+// Every handle owns one queue to insert into and two queues to extract from. Ownership is tracked by a permutation of
+// the `C * p` queues over as many slots. Handle `i` has the three slots `[3i, 3i + 3)`, and the slots `[3p, C * p)`
+// belong to no handle. A slot whose reserved bit is set is owned by its handle, so its queue is accessed without any
+// synchronization. The queues of all other slots are free and only reachable by exchanging them for an owned queue.
+// Handles exchange their queues with random free slots after every `K` operations (a lease) and release them at the end
+// of each lease, which bounds the number of elements only visible to a single handle. A handle that stops pushing in
+// the middle of a lease has to call `flush`. Buffering and the merge heap of the configuration are supported, but
+// stickiness is given by the lease length and pheromones and combining are not used.
+template <typename Key, typename T, typename Comparator = std::less<Key>,
+          typename Configuration = configuration::Default, typename Allocator = std::allocator<Key>>
+class multiqueue_assigned : private multiqueue_base<Key, T, Comparator, typename Configuration::RandomEngine> {
+    static_assert(Configuration::C > 3, "Every handle owns three queues, so there must be more than three per handle");
+    static_assert(Configuration::K >= 1, "Leases must last for at least one operation");
+
+   private:
+    using base_type = multiqueue_base<Key, T, Comparator, typename Configuration::RandomEngine>;
+
+   public:
+    using allocator_type = Allocator;
+    using key_type = typename base_type::key_type;
+    using mapped_type = typename base_type::mapped_type;
+    using value_type = typename base_type::value_type;
+    using key_comparator = typename base_type::key_comparator;
+    using size_type = typename base_type::size_type;
+    struct Handle {
+        friend class multiqueue_assigned;
+
+       private:
+        uint32_t id_;
+
+       private:
+        explicit Handle(unsigned int id) noexcept : id_{static_cast<uint32_t>(id)} {
+        }
+    };
+
+   private:
+    struct alignas(Configuration::NumaFriendly ? PAGESIZE : 2 * L1_CACHE_LINESIZE) InternalPriorityQueueWrapper {
+        using pq_type = internal_priority_queue_t<key_type, mapped_type, key_comparator, Configuration>;
+        using allocator_type = typename Configuration::HeapAllocator;
+        pq_type pq;
+
+        InternalPriorityQueueWrapper() = default;
+
+        explicit InternalPriorityQueueWrapper(Comparator const &comp, allocator_type const &alloc = allocator_type())
+            : pq(comp, alloc) {
+        }
+    };
+
+    struct QueueIndex {
+        alignas(2 * L1_CACHE_LINESIZE) std::atomic<std::uint32_t> index;
+    };
+
+    static constexpr std::uint32_t reserved_mask = static_cast<std::uint32_t>(1) << 31;
+
+    // Slots of each handle
+    static constexpr unsigned int insert_slot = 0;
+    static constexpr std::array<unsigned int, 2> extract_slots = {1, 2};
+
+    static_assert(std::is_same_v<value_type, typename InternalPriorityQueueWrapper::pq_type::heap_type::value_type>);
+
+    using queue_alloc_type = typename allocator_type::template rebind<InternalPriorityQueueWrapper>::other;
+    using alloc_traits = std::allocator_traits<queue_alloc_type>;
+    using base_type::comp_;
+    using base_type::thread_data_;
+
+   private:
+    InternalPriorityQueueWrapper *pq_list_;
+    size_type pq_list_size_;
+    QueueIndex *queue_index_;
+    queue_alloc_type alloc_;
+
+   private:
+    static inline bool is_reserved(std::uint32_t i) noexcept {
+        return (i & reserved_mask) != 0;
+    }
+
+    // The queue owned by the handle in slot `num`, which must be reserved
+    inline InternalPriorityQueueWrapper &owned(Handle handle, unsigned int num) noexcept {
+        auto const i = queue_index_[3 * handle.id_ + num].index.load(std::memory_order_relaxed);
+        assert(is_reserved(i));
+        return pq_list_[i & ~reserved_mask];
+    }
+
+    // Takes ownership of the queue currently assigned to slot `num` of the handle. Other handles might exchange the
+    // queue of the slot concurrently as long as it is free.
+    void reserve(Handle handle, unsigned int num) {
+        auto &slot = queue_index_[3 * handle.id_ + num].index;
+        auto i = slot.load(std::memory_order_relaxed);
+        assert(!is_reserved(i));
+        while (
+            !slot.compare_exchange_weak(i, i | reserved_mask, std::memory_order_acquire, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Gives up ownership of the queue in slot `num` of the handle, which makes it available to other handles
+    inline void release(Handle handle, unsigned int num) noexcept {
+        auto &slot = queue_index_[3 * handle.id_ + num].index;
+        slot.store(slot.load(std::memory_order_relaxed) & ~reserved_mask, std::memory_order_release);
+    }
+
+    // Exchanges the queue owned in slot `num` of the handle with the queue of a random free slot
+    void swap_assignment(Handle handle, unsigned int num) {
+        auto &slot = queue_index_[3 * handle.id_ + num].index;
+        auto const assignment = slot.load(std::memory_order_relaxed);
+        assert(is_reserved(assignment));
+        typename Configuration::Backoff backoff{};
+        while (true) {
+            auto &other = queue_index_[thread_data_[handle.id_].get_random_index()].index;
+            auto other_assignment = other.load(std::memory_order_relaxed);
+            if (!is_reserved(other_assignment) &&
+                other.compare_exchange_strong(other_assignment, assignment & ~reserved_mask, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                slot.store(other_assignment | reserved_mask, std::memory_order_relaxed);
+                return;
+            }
+            backoff();
+        }
+    }
+
+    // Starts a new lease for the slots in `nums`
+    template <typename... Nums>
+    void renew(Handle handle, Nums... nums) {
+        (reserve(handle, nums), ...);
+        (swap_assignment(handle, nums), ...);
+    }
+
+    void init_assignment(std::uint32_t seed, unsigned int num_threads) {
+        queue_index_ = new QueueIndex[pq_list_size_]();
+        std::vector<std::uint32_t> indices(pq_list_size_);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::seed_seq seq{seed + num_threads};
+        std::mt19937 gen(seq);
+        std::shuffle(indices.begin(), indices.end(), gen);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            queue_index_[i].index.store(indices[i], std::memory_order_relaxed);
+        }
+    }
+
+    void init_queues() {
+        {
+            // Only the queue array is interleaved, the heaps are placed by first touch
+#ifdef MULTIQUEUE_HAVE_NUMA
+            util::interleave_scope interleave{Configuration::NumaFriendly};
+#endif
+            pq_list_ = alloc_traits::allocate(alloc_, pq_list_size_);
+            for (std::size_t i = 0; i < pq_list_size_; ++i) {
+                alloc_traits::construct(alloc_, pq_list_ + i, comp_);
+#ifdef MULTIQUEUE_ABORT_MISALIGNED
+                if (reinterpret_cast<std::uintptr_t>(&pq_list_[i]) % (2 * L1_CACHE_LINESIZE) != 0) {
+                    std::abort();
+                }
+#endif
+            }
+        }
+#ifdef MULTIQUEUE_HAVE_NUMA
+        if (Configuration::NumaFriendly) {
+            // Touched in parallel by one worker per handle, each running on the node its queues are placed on
+            util::parallel_first_touch(
+                pq_list_size_, static_cast<unsigned int>(pq_list_size_ / Configuration::C),
+                [this](std::size_t i) { pq_list_[i].pq.heap.reserve_and_touch(Configuration::ReservePerQueue); });
+            return;
+        }
+#endif
+        for (std::size_t i = 0; i < pq_list_size_; ++i) {
+            pq_list_[i].pq.heap.reserve(Configuration::ReservePerQueue);
+        }
+    }
+
+   public:
+    explicit multiqueue_assigned(unsigned int const num_threads, std::uint32_t seed = 0,
+                                 allocator_type const &alloc = allocator_type())
+        : base_type{num_threads, Configuration::C, seed}, pq_list_size_{num_threads * Configuration::C}, alloc_(alloc) {
+        assert(num_threads >= 1);
+        init_assignment(seed, num_threads);
+        init_queues();
+    }
+
+    explicit multiqueue_assigned(unsigned int const num_threads, key_comparator const &comp, std::uint32_t seed = 0,
+                                 allocator_type const &alloc = allocator_type())
+        : base_type{num_threads, Configuration::C, comp, seed},
+          pq_list_size_{num_threads * Configuration::C},
+          alloc_(alloc) {
+        assert(num_threads >= 1);
+        init_assignment(seed, num_threads);
+        init_queues();
+    }
+
+    ~multiqueue_assigned() noexcept {
+        for (size_type i = 0; i < pq_list_size_; ++i) {
+            alloc_traits::destroy(alloc_, pq_list_ + i);
+        }
+        alloc_traits::deallocate(alloc_, pq_list_, pq_list_size_);
+        delete[] queue_index_;
+    }
+
+    Handle get_handle(unsigned int id) const noexcept {
+        return Handle{id};
+    }
+
+    void push(Handle handle, value_type const &value) {
+        auto &data = thread_data_[handle.id_];
+        if (data.insert_count == 0) {
+            renew(handle, insert_slot);
+            data.insert_count = Configuration::K;
+        }
+        owned(handle, insert_slot).pq.push(value);
+        if (--data.insert_count == 0) {
+            release(handle, insert_slot);
+        }
+    }
+
+    // Returns false if both owned extraction queues are empty, even after exchanging them once
+    bool extract_top(Handle handle, value_type &retval) {
+        auto &data = thread_data_[handle.id_];
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            if (data.extract_count[0] == 0) {
+                renew(handle, extract_slots[0], extract_slots[1]);
+                data.extract_count[0] = Configuration::K;
+            } else if (attempt == 1) {
+                swap_assignment(handle, extract_slots[0]);
+                swap_assignment(handle, extract_slots[1]);
+            }
+            auto *first = &owned(handle, extract_slots[0]).pq;
+            auto *second = &owned(handle, extract_slots[1]).pq;
+            bool const first_empty = !first->refresh_top();
+            bool const second_empty = !second->refresh_top();
+            if (first_empty && second_empty) {
+                continue;
+            }
+            if (first_empty || (!second_empty && comp_(second->top().first, first->top().first))) {
+                first = second;
+            }
+            first->extract_top(retval);
+            if (--data.extract_count[0] == 0) {
+                release(handle, extract_slots[0]);
+                release(handle, extract_slots[1]);
+            }
+            return true;
+        }
+        release(handle, extract_slots[0]);
+        release(handle, extract_slots[1]);
+        data.extract_count[0] = 0;
+        return false;
+    }
+
+    // Ends all leases of the handle, so that its owned queues become reachable for other handles
+    void flush(Handle handle) {
+        auto &data = thread_data_[handle.id_];
+        if (data.insert_count != 0) {
+            release(handle, insert_slot);
+            data.insert_count = 0;
+        }
+        if (data.extract_count[0] != 0) {
+            release(handle, extract_slots[0]);
+            release(handle, extract_slots[1]);
+            data.extract_count[0] = 0;
+        }
+    }
+
+    // Must not be called concurrently with other operations
+    std::vector<std::size_t> get_distribution() const {
+        std::vector<std::size_t> distribution(pq_list_size_);
+        std::transform(pq_list_, pq_list_ + pq_list_size_, distribution.begin(),
+                       [](auto const &pq_wrapper) { return pq_wrapper.pq.size(); });
+        return distribution;
+    }
+
+    static std::string description() {
+        std::stringstream ss;
+        ss << "multiqueue assignment\n\t";
+        ss << "C: " << Configuration::C << "\n\t";
+        ss << "Lease length: " << Configuration::K << "\n\t";
+        if (Configuration::UseMergeHeap) {
+            ss << "Using merge heap, node size: " << Configuration::NodeSize << "\n\t";
+        } else {
+            if (Configuration::WithDeletionBuffer) {
+                ss << "Using deletion buffer with size: " << Configuration::DeletionBufferSize << "\n\t";
+            }
+            if (Configuration::WithInsertionBuffer) {
+                ss << "Using insertion buffer with size: " << Configuration::InsertionBufferSize << "\n\t";
+            }
+            ss << "Heap degree: " << Configuration::HeapDegree << "\n\t";
+        }
+        if (Configuration::NumaFriendly) {
+            ss << "Numa friendly\n\t";
+#ifndef MULTIQUEUE_HAVE_NUMA
+            ss << "But numasupport disabled!\n\t";
+#endif
+        }
+#ifdef MULTIQUEUE_ABORT_MISALIGNED
+        ss << "Abort on misalignment\n\t";
+#endif
+        if (Configuration::HeapBlockSize > 0) {
+            ss << "Heap storage in blocks of " << Configuration::HeapBlockSize << " elements\n\t";
+        }
+        ss << "Preallocation for " << Configuration::ReservePerQueue << " elements per internal pq";
+        return ss.str();
+    }
+};
+
+}  // namespace multiqueue
+
+#endif  //! MULTIQUEUE_ASSIGNED_HPP_INCLUDED
@@ -0,0 +1,260 @@
+/**
+******************************************************************************
+* @file:   addressable_heap.hpp
+*
+* @brief:  d-ary heap over externally owned nodes supporting decrease_key and erase
+*******************************************************************************
+**/
+#pragma once
+#ifndef SEQUENTIAL_HEAP_ADDRESSABLE_HEAP_HPP_INCLUDED
+#define SEQUENTIAL_HEAP_ADDRESSABLE_HEAP_HPP_INCLUDED
+
+#include <algorithm>    // min
+#include <cassert>
+#include <cstddef>
+#include <functional>   // less
+#include <limits>
+#include <memory>       // allocator
+#include <type_traits>  // is_invocable_r
+#include <utility>      // move, pair
+#include <vector>
+
+namespace multiqueue {
+namespace sequential {
+
+template <typename Key, typename T, typename Comparator, unsigned int Degree, typename Allocator>
+class addressable_heap;
+
+// The heap does not own its nodes, they must stay at the same address while contained in a heap
+template <typename Key, typename T>
+class addressable_node {
+    template <typename, typename, typename, unsigned int, typename>
+    friend class addressable_heap;
+
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+   private:
+    key_type key_;
+    mapped_type value_;
+    std::size_t position_ = npos;
+
+   public:
+    addressable_node() = default;
+    addressable_node(addressable_node const &) = delete;
+    addressable_node &operator=(addressable_node const &) = delete;
+
+    inline key_type const &key() const noexcept {
+        return key_;
+    }
+
+    inline mapped_type const &value() const noexcept {
+        return value_;
+    }
+};
+
+template <typename Key, typename T, typename Comparator = std::less<Key>, unsigned int Degree = 4,
+          typename Allocator = std::allocator<addressable_node<Key, T> *>>
+class addressable_heap : private Comparator {
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<key_type, mapped_type>;
+    using comp_type = Comparator;
+    using node_type = addressable_node<Key, T>;
+    using allocator_type = Allocator;
+    using container_type = std::vector<node_type *, allocator_type>;
+    using size_type = std::size_t;
+
+    static_assert(std::is_invocable_r_v<bool, comp_type const &, key_type const &, key_type const &>,
+                  "Keys must be comparable using the signature `bool Comparator(Key const&, Key const&) const &`");
+    static_assert(Degree >= 1, "Degree must be at least one");
+
+   private:
+    container_type data_;
+
+   private:
+    static constexpr size_type parent_index(size_type const index) noexcept {
+        return (index - 1) / Degree;
+    }
+
+    static constexpr size_type first_child_index(size_type const index) noexcept {
+        return index * Degree + 1;
+    }
+
+    constexpr bool compare(key_type const &lhs, key_type const &rhs) const {
+        return static_cast<comp_type const &>(*this)(lhs, rhs);
+    }
+
+    inline void place(node_type *node, size_type const index) noexcept {
+        data_[index] = node;
+        node->position_ = index;
+    }
+
+    // Moves `node` from the hole at `index` towards the root until its parent is not larger
+    void sift_up(node_type *node, size_type index) {
+        while (index > 0) {
+            auto const parent = parent_index(index);
+            if (!compare(node->key_, data_[parent]->key_)) {
+                break;
+            }
+            place(data_[parent], index);
+            index = parent;
+        }
+        place(node, index);
+    }
+
+    // Moves `node` from the hole at `index` towards the leaves until no child is smaller
+    void sift_down(node_type *node, size_type index) {
+        while (true) {
+            auto child = first_child_index(index);
+            if (child >= size()) {
+                break;
+            }
+            auto const last = std::min(child + Degree, size());
+            auto min_child = child;
+            for (++child; child < last; ++child) {
+                if (compare(data_[child]->key_, data_[min_child]->key_)) {
+                    min_child = child;
+                }
+            }
+            if (!compare(data_[min_child]->key_, node->key_)) {
+                break;
+            }
+            place(data_[min_child], index);
+            index = min_child;
+        }
+        place(node, index);
+    }
+
+    // Fills the hole at `index` with the last node
+    void remove_at(size_type const index) {
+        assert(index < size());
+        data_[index]->position_ = node_type::npos;
+        node_type *last = data_.back();
+        data_.pop_back();
+        if (index == size()) {
+            return;
+        }
+        if (index > 0 && compare(last->key_, data_[parent_index(index)]->key_)) {
+            sift_up(last, index);
+        } else {
+            sift_down(last, index);
+        }
+    }
+
+#ifndef NDEBUG
+    bool is_heap() const {
+        for (size_type i = 0; i < size(); ++i) {
+            if (data_[i]->position_ != i) {
+                return false;
+            }
+            if (i > 0 && compare(data_[i]->key_, data_[parent_index(i)]->key_)) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
+   public:
+    addressable_heap() = default;
+
+    explicit addressable_heap(comp_type const &comp, allocator_type const &alloc = allocator_type())
+        : comp_type(comp), data_(alloc) {
+    }
+
+    constexpr comp_type const &get_comparator() const noexcept {
+        return *this;
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        return data_.empty();
+    }
+
+    inline size_type size() const noexcept {
+        return data_.size();
+    }
+
+    inline node_type &top() const {
+        assert(!empty());
+        return *data_.front();
+    }
+
+    // Only meaningful if the node is not contained in a different heap
+    static inline bool contains(node_type const &node) noexcept {
+        return node.position_ != node_type::npos;
+    }
+
+    void push(node_type &node, key_type const &key, mapped_type const &value) {
+        assert(!contains(node));
+        node.key_ = key;
+        node.value_ = value;
+        data_.push_back(nullptr);
+        sift_up(&node, size() - 1);
+        assert(is_heap());
+    }
+
+    void pop() {
+        assert(!empty());
+        remove_at(0);
+        assert(is_heap());
+    }
+
+    void extract_top(value_type &retval) {
+        assert(!empty());
+        retval.first = data_.front()->key_;
+        retval.second = data_.front()->value_;
+        pop();
+    }
+
+    // Sets the key of a contained node to `key`, which may be smaller or larger than its current key
+    void change_key(node_type &node, key_type const &key) {
+        assert(contains(node) && data_[node.position_] == &node);
+        bool const decrease = compare(key, node.key_);
+        node.key_ = key;
+        if (decrease) {
+            sift_up(&node, node.position_);
+        } else {
+            sift_down(&node, node.position_);
+        }
+        assert(is_heap());
+    }
+
+    // Returns false and leaves the node unchanged if `key` is not smaller than its current key
+    bool decrease_key(node_type &node, key_type const &key) {
+        assert(contains(node) && data_[node.position_] == &node);
+        if (!compare(key, node.key_)) {
+            return false;
+        }
+        node.key_ = key;
+        sift_up(&node, node.position_);
+        assert(is_heap());
+        return true;
+    }
+
+    void erase(node_type &node) {
+        assert(contains(node) && data_[node.position_] == &node);
+        remove_at(node.position_);
+        assert(is_heap());
+    }
+
+    inline void reserve(std::size_t const cap) {
+        data_.reserve(cap);
+    }
+
+    inline void clear() noexcept {
+        for (auto node : data_) {
+            node->position_ = node_type::npos;
+        }
+        data_.clear();
+    }
+};
+
+}  // namespace sequential
+}  // namespace multiqueue
+
+#endif  //! SEQUENTIAL_HEAP_ADDRESSABLE_HEAP_HPP_INCLUDED
@@ -13,11 +13,12 @@
 
 #include "multiqueue/sequential/heap/full_down_strategy.hpp"
 #include "multiqueue/util/extractors.hpp"
+#include "multiqueue/util/segmented_vector.hpp"
 
 #include <cassert>
 #include <cstddef>
 #include <memory>       // allocator
-#include <type_traits>  // is_constructible, enable_if
+#include <type_traits>  // is_constructible, enable_if, conditional
 #include <utility>      // move, forward, pair
 #include <vector>
 
@@ -72,8 +73,10 @@ struct heap_base : private KeyExtractor, private Comparator {
     }
 };
 
+// With a `BlockSize` of zero, the elements are stored in one contiguous vector. Otherwise, they are stored in blocks
+// of `BlockSize` elements, so that growing the heap never moves existing elements.
 template <typename T, typename Key, typename KeyExtractor, typename Comparator, unsigned int Degree,
-          typename SiftStrategy, typename Allocator>
+          typename SiftStrategy, typename Allocator, std::size_t BlockSize = 0>
 class heap : private heap_base<T, Key, KeyExtractor, Comparator> {
     friend SiftStrategy;
     using base_type = heap_base<T, Key, KeyExtractor, Comparator>;
@@ -90,7 +93,9 @@ class heap : private heap_base<T, Key, KeyExtractor, Comparator> {
     using const_reference = typename base_type::const_reference;
 
     using allocator_type = Allocator;
-    using container_type = std::vector<typename heap::value_type, allocator_type>;
+    using container_type =
+        std::conditional_t<BlockSize == 0, std::vector<value_type, allocator_type>,
+                           util::segmented_vector<value_type, BlockSize, allocator_type>>;
     using iterator = typename container_type::const_iterator;
     using const_iterator = typename container_type::const_iterator;
     using difference_type = typename container_type::difference_type;
@@ -269,13 +274,15 @@ class heap : private heap_base<T, Key, KeyExtractor, Comparator> {
 };
 
 template <typename T, typename Comparator = std::less<T>, unsigned int Degree = 4,
-          typename SiftStrategy = sift_strategy::FullDown, typename Allocator = std::allocator<T>>
-using value_heap = heap<T, T, util::identity<T>, Comparator, Degree, SiftStrategy, Allocator>;
+          typename SiftStrategy = sift_strategy::FullDown, typename Allocator = std::allocator<T>,
+          std::size_t BlockSize = 0>
+using value_heap = heap<T, T, util::identity<T>, Comparator, Degree, SiftStrategy, Allocator, BlockSize>;
 
 template <typename Key, typename T, typename Comparator = std::less<Key>, unsigned int Degree = 4,
-          typename SiftStrategy = sift_strategy::FullDown, typename Allocator = std::allocator<std::pair<Key, T>>>
-using key_value_heap =
-    heap<std::pair<Key, T>, Key, util::get_nth<std::pair<Key, T>, 0>, Comparator, Degree, SiftStrategy, Allocator>;
+          typename SiftStrategy = sift_strategy::FullDown, typename Allocator = std::allocator<std::pair<Key, T>>,
+          std::size_t BlockSize = 0>
+using key_value_heap = heap<std::pair<Key, T>, Key, util::get_nth<std::pair<Key, T>, 0>, Comparator, Degree,
+                            SiftStrategy, Allocator, BlockSize>;
 
 }  // namespace sequential
 }  // namespace multiqueue
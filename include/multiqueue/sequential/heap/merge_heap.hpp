@@ -14,20 +14,24 @@
 #include "multiqueue/sequential/heap/heap.hpp"
 #include "multiqueue/util/extractors.hpp"
 #include "multiqueue/util/inplace_merge.hpp"
+#include "multiqueue/util/segmented_vector.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iterator>
 #include <memory>       // allocator
-#include <type_traits>  // is_constructible, enable_if
+#include <type_traits>  // is_constructible, enable_if, conditional
 #include <utility>      // move, forward
 #include <vector>
 
 namespace multiqueue {
 namespace sequential {
 
+// With a `BlockSize` of zero, the nodes are stored in one contiguous vector. Otherwise, they are stored in blocks of
+// `BlockSize` nodes, so that growing the heap never moves existing nodes.
 template <typename T, typename Key, typename KeyExtractor, typename Comparator, std::size_t NodeSize,
-          typename Allocator = std::allocator<T>>
+          typename Allocator = std::allocator<T>, std::size_t BlockSize = 0>
 class merge_heap : private heap_base<T, Key, KeyExtractor, Comparator> {
     using base_type = heap_base<T, Key, KeyExtractor, Comparator>;
     using base_type::extract_key;
@@ -44,7 +48,8 @@ class merge_heap : private heap_base<T, Key, KeyExtractor, Comparator> {
 
     using node_type = std::array<value_type, NodeSize>;
     using allocator_type = Allocator;
-    using container_type = std::vector<node_type>;
+    using container_type = std::conditional_t<BlockSize == 0, std::vector<node_type>,
+                                              util::segmented_vector<node_type, BlockSize, std::allocator<node_type>>>;
     using iterator = typename container_type::const_iterator;
     using const_iterator = typename container_type::const_iterator;
     using difference_type = typename container_type::difference_type;
@@ -169,7 +174,7 @@ class merge_heap : private heap_base<T, Key, KeyExtractor, Comparator> {
     inline void reserve_and_touch(std::size_t const cap) {
         auto const num_nodes = cap / NodeSize + (cap % NodeSize == 0 ? 0 : 1);
         if (data_.size() < num_nodes) {
-            size_type const old_size = size();
+            size_type const old_size = data_.size();
             data_.resize(num_nodes);
             // this does not free allocated memory
             data_.resize(old_size);
@@ -247,13 +252,13 @@ class merge_heap : private heap_base<T, Key, KeyExtractor, Comparator> {
 };
 
 template <typename T, typename Comparator = std::less<T>, std::size_t NodeSize = 64,
-          typename Allocator = std::allocator<T>>
-using value_merge_heap = merge_heap<T, T, util::identity<T>, Comparator, NodeSize, Allocator>;
+          typename Allocator = std::allocator<T>, std::size_t BlockSize = 0>
+using value_merge_heap = merge_heap<T, T, util::identity<T>, Comparator, NodeSize, Allocator, BlockSize>;
 
 template <typename Key, typename T, typename Comparator = std::less<Key>, std::size_t NodeSize = 64,
-          typename Allocator = std::allocator<std::pair<Key, T>>>
-using key_value_merge_heap =
-    merge_heap<std::pair<Key, T>, Key, util::get_nth<std::pair<Key, T>, 0>, Comparator, NodeSize, Allocator>;
+          typename Allocator = std::allocator<std::pair<Key, T>>, std::size_t BlockSize = 0>
+using key_value_merge_heap = merge_heap<std::pair<Key, T>, Key, util::get_nth<std::pair<Key, T>, 0>, Comparator,
+                                        NodeSize, Allocator, BlockSize>;
 
 }  // namespace sequential
 }  // namespace multiqueue
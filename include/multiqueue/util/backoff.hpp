@@ -0,0 +1,78 @@
+/**
+******************************************************************************
+* @file:   backoff.hpp
+*
+* @brief:  Policies for waiting between failed attempts to acquire a lock
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_BACKOFF_HPP_INCLUDED
+#define UTIL_BACKOFF_HPP_INCLUDED
+
+#include <algorithm>
+#include <thread>
+
+namespace multiqueue {
+namespace util {
+
+// Hints the processor that we are in a spin loop
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// A backoff policy is default-constructed at the beginning of each operation and invoked after every failed attempt
+// of this operation to acquire a lock.
+namespace backoff {
+
+// Retries immediately
+struct None {
+    inline void operator()() noexcept {
+    }
+};
+
+// Issues one pause instruction per failed attempt
+struct Pause {
+    inline void operator()() noexcept {
+        cpu_relax();
+    }
+};
+
+// Starts with `Min` pause instructions and doubles them after each failed attempt up to `Max`
+template <unsigned int Min = 1, unsigned int Max = 1024>
+struct Exponential {
+    static_assert(Min > 0 && Min <= Max, "Min must be positive and not greater than Max");
+
+    unsigned int spins = Min;
+
+    inline void operator()() noexcept {
+        for (unsigned int i = 0; i < spins; ++i) {
+            cpu_relax();
+        }
+        spins = std::min(2 * spins, Max);
+    }
+};
+
+// Issues one pause instruction for each of the first `N` failed attempts and yields the thread afterwards
+template <unsigned int N = 16>
+struct Yield {
+    unsigned int attempts = 0;
+
+    inline void operator()() noexcept {
+        if (attempts < N) {
+            ++attempts;
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+}  // namespace backoff
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_BACKOFF_HPP_INCLUDED
@@ -0,0 +1,86 @@
+/**
+******************************************************************************
+* @file:   combining.hpp
+*
+* @brief:  Publication slots to delegate operations to the holder of a lock
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_COMBINING_HPP_INCLUDED
+#define UTIL_COMBINING_HPP_INCLUDED
+
+#include "system_config.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace multiqueue {
+namespace util {
+
+// A thread that fails to acquire a lock posts its request into a free slot and waits until it is served. Requests
+// are only served and withdrawn while holding the associated lock, so a requester that acquires the lock itself can
+// safely check whether its request is still pending.
+template <typename T, std::size_t N>
+class publication_list {
+   public:
+    enum class request : std::uint32_t { none, claimed, push, extract, done, failed };
+
+   private:
+    struct alignas(L1_CACHE_LINESIZE) Slot {
+        std::atomic<request> state{request::none};
+        std::uint32_t id;
+        T value;
+    };
+
+    std::array<Slot, N> slots_;
+
+   public:
+    static constexpr std::size_t npos = N;
+
+    // Returns the slot of the request or `npos` if all slots are taken
+    std::size_t post(request kind, std::uint32_t id, T const &value) {
+        for (std::size_t i = 0; i < N; ++i) {
+            auto expected = request::none;
+            if (slots_[i].state.load(std::memory_order_relaxed) == request::none &&
+                slots_[i].state.compare_exchange_strong(expected, request::claimed, std::memory_order_relaxed)) {
+                slots_[i].id = id;
+                slots_[i].value = value;
+                slots_[i].state.store(kind, std::memory_order_release);
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    inline request poll(std::size_t slot) const noexcept {
+        return slots_[slot].state.load(std::memory_order_acquire);
+    }
+
+    inline T &value(std::size_t slot) noexcept {
+        return slots_[slot].value;
+    }
+
+    inline void release(std::size_t slot) noexcept {
+        slots_[slot].state.store(request::none, std::memory_order_release);
+    }
+
+    // Must be called while holding the lock. `apply(kind, id, value)` performs a pending request and returns
+    // whether it succeeded.
+    template <typename Apply>
+    void combine(Apply &&apply) {
+        for (auto &slot : slots_) {
+            auto const kind = slot.state.load(std::memory_order_acquire);
+            if (kind == request::push || kind == request::extract) {
+                bool const success = apply(kind, slot.id, slot.value);
+                slot.state.store(success ? request::done : request::failed, std::memory_order_release);
+            }
+        }
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_COMBINING_HPP_INCLUDED
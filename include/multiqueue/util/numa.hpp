@@ -0,0 +1,147 @@
+/**
+******************************************************************************
+* @file:   numa.hpp
+*
+* @brief:  Helpers to map handles and local queues to numa nodes
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_NUMA_HPP_INCLUDED
+#define UTIL_NUMA_HPP_INCLUDED
+
+#include "system_config.hpp"
+
+#ifdef MULTIQUEUE_HAVE_NUMA
+#include <numa.h>
+#include <numaif.h>
+#include <sched.h>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace multiqueue {
+namespace util {
+
+inline unsigned int numa_node_count() noexcept {
+#ifdef MULTIQUEUE_HAVE_NUMA
+    if (numa_available() >= 0) {
+        return static_cast<unsigned int>(numa_max_node()) + 1;
+    }
+#endif
+    return 1;
+}
+
+// Node of the cpu the calling thread currently runs on
+inline unsigned int current_numa_node() noexcept {
+#ifdef MULTIQUEUE_HAVE_NUMA
+    if (numa_available() >= 0) {
+        int const node = numa_node_of_cpu(sched_getcpu());
+        if (node >= 0) {
+            return static_cast<unsigned int>(node);
+        }
+    }
+#endif
+    return 0;
+}
+
+#ifdef MULTIQUEUE_HAVE_NUMA
+// While in scope and `enabled` is set, memory allocated by the calling thread is interleaved over all nodes. The
+// previous memory policy of the thread is restored afterwards, also if it was not the default policy.
+class interleave_scope {
+    bitmask *nodes_ = nullptr;
+    int mode_ = MPOL_DEFAULT;
+
+   public:
+    explicit interleave_scope(bool enabled) noexcept {
+        if (!enabled || numa_available() < 0) {
+            return;
+        }
+        nodes_ = numa_allocate_nodemask();
+        if (get_mempolicy(&mode_, nodes_->maskp, nodes_->size + 1, nullptr, 0) != 0) {
+            numa_free_nodemask(nodes_);
+            nodes_ = nullptr;
+            return;
+        }
+        numa_set_interleave_mask(numa_all_nodes_ptr);
+    }
+
+    interleave_scope(interleave_scope const &) = delete;
+    interleave_scope &operator=(interleave_scope const &) = delete;
+
+    ~interleave_scope() noexcept {
+        if (nodes_ != nullptr) {
+            set_mempolicy(mode_, nodes_->maskp, nodes_->size + 1);
+            numa_free_nodemask(nodes_);
+        }
+    }
+};
+#endif
+
+// The queues [first, second) placed on `node` if `num_queues` queues are split into equal consecutive blocks, one per
+// node, as done by the constructors of numa friendly multiqueues. The last node also gets the remaining queues.
+inline std::pair<std::size_t, std::size_t> numa_local_range(std::size_t num_queues, unsigned int node,
+                                                            unsigned int num_nodes) noexcept {
+    num_nodes = std::max(1U, num_nodes);
+    node = std::min(node, num_nodes - 1);
+    std::size_t const per_node = std::max<std::size_t>(1, num_queues / num_nodes);
+    std::size_t const first = std::min(num_queues, node * per_node);
+    std::size_t const last = node + 1 == num_nodes ? num_queues : std::min(num_queues, first + per_node);
+    return {first, last};
+}
+
+// Calls `touch(i)` for every queue index i in [0, `num_queues`) on up to `num_workers` threads (at most one per
+// hardware thread). Each worker runs on the node that `numa_local_range` places its queues on, so memory first touched
+// by `touch` is allocated on that node without changing the memory policy of the calling thread. Exceptions thrown by
+// `touch` are rethrown after all workers finished.
+template <typename Touch>
+void parallel_first_touch(std::size_t num_queues, unsigned int num_workers, Touch touch) {
+    unsigned int const num_nodes = numa_node_count();
+    num_workers = std::clamp(num_workers, num_nodes, std::max(num_nodes, std::thread::hardware_concurrency()));
+    unsigned int const workers_per_node = num_workers / num_nodes;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::vector<std::thread> workers;
+    for (unsigned int node = 0; node < num_nodes; ++node) {
+        auto const [first, last] = numa_local_range(num_queues, node, num_nodes);
+        std::size_t const per_worker = (last - first + workers_per_node - 1) / workers_per_node;
+        for (std::size_t begin = first; begin < last; begin += per_worker) {
+            std::size_t const end = std::min(last, begin + per_worker);
+            workers.emplace_back([&touch, &error, &error_mutex, node, num_nodes, begin, end]() {
+#ifdef MULTIQUEUE_HAVE_NUMA
+                if (num_nodes > 1) {
+                    numa_run_on_node(static_cast<int>(node));
+                }
+#else
+                (void)node;
+                (void)num_nodes;
+#endif
+                try {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        touch(i);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock{error_mutex};
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            });
+        }
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_NUMA_HPP_INCLUDED
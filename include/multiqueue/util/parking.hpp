@@ -0,0 +1,93 @@
+/**
+******************************************************************************
+* @file:   parking.hpp
+*
+* @brief:  Lets idle consumers sleep until a producer signals new elements
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_PARKING_HPP_INCLUDED
+#define UTIL_PARKING_HPP_INCLUDED
+
+#include "system_config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <ctime>
+#endif
+
+namespace multiqueue {
+namespace util {
+
+// Consumers announce themselves with `prepare_park()`, re-check for work and then either `park()` or
+// `cancel_park()`. Producers call `notify()` after publishing work, which costs a single relaxed load if nobody
+// sleeps. Since this load is not ordered with the announcement of a consumer, a wakeup can be lost, so consumers
+// must only park for bounded slices and re-check for work afterwards.
+class parking {
+    std::chrono::nanoseconds slice_;
+    alignas(L1_CACHE_LINESIZE) std::atomic_uint32_t sleepers_{0};
+    alignas(L1_CACHE_LINESIZE) std::atomic_uint32_t epoch_{0};
+
+   public:
+    // Default upper bound for a single park, after which the consumer re-checks for work
+    static constexpr std::chrono::microseconds default_slice{1000};
+
+    explicit parking(std::chrono::nanoseconds slice = default_slice) noexcept : slice_{slice} {
+    }
+
+    inline std::chrono::nanoseconds slice() const noexcept {
+        return slice_;
+    }
+
+    inline std::uint32_t prepare_park() noexcept {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_seq_cst);
+    }
+
+    inline void cancel_park() noexcept {
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Sleeps until notified or `timeout` (at most the slice) elapsed, returns immediately if there was a notification
+    // since `epoch` was obtained
+    inline void park(std::uint32_t epoch, std::chrono::nanoseconds timeout) noexcept {
+        if (timeout > slice_) {
+            timeout = slice_;
+        }
+#ifdef __linux__
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1'000'000'000);
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, &ts, nullptr, 0);
+#else
+        if (epoch_.load(std::memory_order_acquire) == epoch) {
+            std::this_thread::sleep_for(timeout);
+        }
+#endif
+        cancel_park();
+    }
+
+    inline void notify() noexcept {
+        if (sleepers_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr,
+                0);
+#endif
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_PARKING_HPP_INCLUDED
@@ -0,0 +1,212 @@
+/**
+******************************************************************************
+* @file:   quality.hpp
+*
+* @brief:  Online estimation of rank error and delay from a sample of keys
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_QUALITY_HPP_INCLUDED
+#define UTIL_QUALITY_HPP_INCLUDED
+
+#include "system_config.hpp"
+
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace multiqueue {
+namespace util {
+
+// Counts of values in buckets of powers of two. Bucket 0 counts zeros and bucket i > 0 counts values in
+// [2^(i - 1), 2^i).
+struct log_histogram {
+    static constexpr std::size_t num_buckets = 65;
+
+    std::array<std::uint64_t, num_buckets> buckets{};
+
+    static inline std::size_t bucket(std::uint64_t value) noexcept {
+        return value == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(value));
+    }
+
+    std::uint64_t total() const noexcept {
+        std::uint64_t sum = 0;
+        for (auto b : buckets) {
+            sum += b;
+        }
+        return sum;
+    }
+
+    // Upper bound of the bucket containing the `q`-quantile, zero if the histogram is empty
+    std::uint64_t quantile(double q) const noexcept {
+        auto const n = total();
+        if (n == 0) {
+            return 0;
+        }
+        auto const target = static_cast<std::uint64_t>(q * static_cast<double>(n - 1));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            seen += buckets[i];
+            if (seen > target) {
+                return i == 0 ? 0 : (i == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << i) - 1);
+            }
+        }
+        return ~std::uint64_t{0};
+    }
+
+    log_histogram &operator+=(log_histogram const &other) noexcept {
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        return *this;
+    }
+};
+
+// Rank error and delay (in nanoseconds) of sampled extractions
+struct quality_histograms {
+    log_histogram rank_error;
+    log_histogram delay;
+
+    quality_histograms &operator+=(quality_histograms const &other) noexcept {
+        rank_error += other.rank_error;
+        delay += other.delay;
+        return *this;
+    }
+};
+
+// Keys are sampled by a hash, so that an extracted key is known to be sampled without storing anything in the
+// elements. All sampled elements currently contained are kept in an order statistics tree to determine how many
+// smaller sampled elements were contained when one of them is extracted. Scaled by the inverse sample rate, this
+// estimates the rank error. The delay is the time the element was contained. Only sampled operations take the lock of
+// the tree, and each handle records into its own histograms, which can be read concurrently.
+template <typename Key>
+class quality_monitor {
+    static_assert(std::is_unsigned_v<Key>, "Key must be unsigned integer");
+
+    // Sampled keys with the sequence number of their push, mapped to the time of the push
+    using tree_type = __gnu_pbds::tree<std::pair<Key, std::uint64_t>, std::int64_t, std::less<>,
+                                       __gnu_pbds::rb_tree_tag, __gnu_pbds::tree_order_statistics_node_update>;
+
+    struct alignas(2 * L1_CACHE_LINESIZE) HandleHistograms {
+        std::array<std::atomic_uint64_t, log_histogram::num_buckets> rank_error{};
+        std::array<std::atomic_uint64_t, log_histogram::num_buckets> delay{};
+    };
+
+    std::uint64_t threshold_ = 0;
+    double scale_ = 1.0;
+    std::mutex mutex_;
+    tree_type contained_;
+    std::uint64_t sequence_ = 0;
+    std::unique_ptr<HandleHistograms[]> histograms_;
+    unsigned int num_handles_;
+
+    static inline std::uint64_t mix(std::uint64_t x) noexcept {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    static inline std::int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Only written by the owning handle
+    static inline void record(std::array<std::atomic_uint64_t, log_histogram::num_buckets> &buckets,
+                              std::uint64_t value) noexcept {
+        auto &b = buckets[log_histogram::bucket(value)];
+        b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static log_histogram load(std::array<std::atomic_uint64_t, log_histogram::num_buckets> const &buckets) noexcept {
+        log_histogram h;
+        for (std::size_t i = 0; i < log_histogram::num_buckets; ++i) {
+            h.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        return h;
+    }
+
+   public:
+    quality_monitor(unsigned int num_handles, double sample_rate)
+        : histograms_(new HandleHistograms[num_handles]), num_handles_{num_handles} {
+        if (sample_rate >= 1.0) {
+            threshold_ = ~std::uint64_t{0};
+        } else if (sample_rate > 0.0) {
+            // The conversion is undefined for values of 2^64 and above
+            double const threshold = sample_rate * 18446744073709551616.0;
+            threshold_ = threshold >= 18446744073709551616.0 ? ~std::uint64_t{0}
+                                                             : static_cast<std::uint64_t>(threshold);
+            scale_ = 1.0 / sample_rate;
+        }
+    }
+
+    inline bool sampled(Key key) const noexcept {
+        return mix(static_cast<std::uint64_t>(key) + 0x9e3779b97f4a7c15) < threshold_;
+    }
+
+    // Must be called before the element becomes visible to other handles
+    void on_push(Key key) {
+        if (!sampled(key)) {
+            return;
+        }
+        auto const time = now();
+        std::lock_guard<std::mutex> lock{mutex_};
+        contained_.insert({{key, ++sequence_}, time});
+    }
+
+    void on_extract(unsigned int id, Key key) {
+        if (!sampled(key)) {
+            return;
+        }
+        auto const time = now();
+        std::uint64_t rank;
+        std::int64_t pushed;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            // Elements with equal keys are indistinguishable, so the oldest one is regarded as extracted
+            auto it = contained_.lower_bound({key, 0});
+            if (it == contained_.end() || it->first.first != key) {
+                return;
+            }
+            rank = contained_.order_of_key({key, 0});
+            pushed = it->second;
+            contained_.erase(it);
+        }
+        record(histograms_[id].rank_error, static_cast<std::uint64_t>(static_cast<double>(rank) * scale_));
+        record(histograms_[id].delay, time > pushed ? static_cast<std::uint64_t>(time - pushed) : 0);
+    }
+
+    quality_histograms histograms(unsigned int id) const noexcept {
+        return {load(histograms_[id].rank_error), load(histograms_[id].delay)};
+    }
+
+    quality_histograms histograms() const noexcept {
+        quality_histograms sum;
+        for (unsigned int i = 0; i < num_handles_; ++i) {
+            sum += histograms(i);
+        }
+        return sum;
+    }
+};
+
+// Stand-in if quality is not measured
+struct no_quality_monitor {
+    no_quality_monitor(unsigned int, double) noexcept {
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_QUALITY_HPP_INCLUDED
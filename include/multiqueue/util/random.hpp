@@ -0,0 +1,226 @@
+/**
+******************************************************************************
+* @file:   random.hpp
+*
+* @brief:  Small random engines and fast sampling of queue indices
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_RANDOM_HPP_INCLUDED
+#define UTIL_RANDOM_HPP_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace multiqueue {
+namespace util {
+
+// All engines satisfy the requirements of a uniform random bit generator and can be seeded with a seed sequence
+
+class splitmix64 {
+    std::uint64_t state_;
+
+   public:
+    using result_type = std::uint64_t;
+
+    explicit splitmix64(std::uint64_t seed = 0) noexcept : state_{seed} {
+    }
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    inline void seed(std::uint64_t seed) noexcept {
+        state_ = seed;
+    }
+
+    template <typename SeedSeq>
+    void seed(SeedSeq &seq) {
+        std::array<std::uint32_t, 2> words;
+        seq.generate(words.begin(), words.end());
+        state_ = (static_cast<std::uint64_t>(words[1]) << 32) | words[0];
+    }
+
+    inline result_type operator()() noexcept {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+};
+
+class wyrand {
+    std::uint64_t state_;
+
+   public:
+    using result_type = std::uint64_t;
+
+    explicit wyrand(std::uint64_t seed = 0) noexcept : state_{seed} {
+    }
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    inline void seed(std::uint64_t seed) noexcept {
+        state_ = seed;
+    }
+
+    template <typename SeedSeq>
+    void seed(SeedSeq &seq) {
+        std::array<std::uint32_t, 2> words;
+        seq.generate(words.begin(), words.end());
+        state_ = (static_cast<std::uint64_t>(words[1]) << 32) | words[0];
+    }
+
+    inline result_type operator()() noexcept {
+        state_ += 0xa0761d6478bd642f;
+        __uint128_t const product = static_cast<__uint128_t>(state_) * (state_ ^ 0xe7037ed1a0b428db);
+        return static_cast<std::uint64_t>(product >> 64) ^ static_cast<std::uint64_t>(product);
+    }
+};
+
+class xoshiro256starstar {
+    std::array<std::uint64_t, 4> state_;
+
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) noexcept {
+        return (x << k) | (x >> (64 - k));
+    }
+
+   public:
+    using result_type = std::uint64_t;
+
+    explicit xoshiro256starstar(std::uint64_t seed = 0) noexcept {
+        this->seed(seed);
+    }
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    // The state must not be all zero, so it is expanded from the seed with splitmix64
+    inline void seed(std::uint64_t seed) noexcept {
+        splitmix64 expand{seed};
+        for (auto &s : state_) {
+            s = expand();
+        }
+    }
+
+    template <typename SeedSeq>
+    void seed(SeedSeq &seq) {
+        std::array<std::uint32_t, 2> words;
+        seq.generate(words.begin(), words.end());
+        seed((static_cast<std::uint64_t>(words[1]) << 32) | words[0]);
+    }
+
+    inline result_type operator()() noexcept {
+        auto const result = rotl(state_[1] * 5, 7) * 9;
+        auto const t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+};
+
+// Draws 64 random bits, using two draws for engines with 32 bit output such as `std::mt19937`
+template <typename Engine>
+inline std::uint64_t draw64(Engine &gen) {
+    static_assert(Engine::min() == 0, "Engine must produce 32 or 64 random bits");
+    if constexpr (Engine::max() == std::numeric_limits<std::uint64_t>::max()) {
+        return gen();
+    } else {
+        static_assert(Engine::max() == std::numeric_limits<std::uint32_t>::max(),
+                      "Engine must produce 32 or 64 random bits");
+        auto const low = static_cast<std::uint64_t>(gen());
+        return (static_cast<std::uint64_t>(gen()) << 32) | low;
+    }
+}
+
+// Maps 32 random bits to [0, n) with a multiplication and a shift (Lemire). Without rejection, the bias is at most
+// n / 2^32, which is negligible for queue indices.
+inline std::uint32_t reduce(std::uint32_t bits, std::uint32_t n) noexcept {
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(bits) * n) >> 32);
+}
+
+// Samples indices in [0, size), two of them from a single 64 bit draw. Optionally prefers a local range of indices
+// and only samples from all indices with a given probability.
+template <typename Engine>
+class index_sampler {
+    Engine gen_;
+    std::uint32_t size_ = 1;
+    std::uint32_t local_first_ = 0;
+    // Zero if there is no local range
+    std::uint32_t local_size_ = 0;
+    // A draw samples from all indices if its upper half is below this threshold
+    std::uint32_t remote_threshold_ = 0;
+
+   public:
+    template <typename SeedSeq>
+    void seed(SeedSeq &seq) {
+        gen_.seed(seq);
+    }
+
+    inline std::size_t size() const noexcept {
+        return size_;
+    }
+
+    inline void set_size(std::size_t size) noexcept {
+        assert(size >= 1 && size <= std::numeric_limits<std::uint32_t>::max());
+        size_ = static_cast<std::uint32_t>(size);
+    }
+
+    // Samples from [first, last) with probability 1 - `remote_probability` and from all indices otherwise
+    inline void set_local_range(std::size_t first, std::size_t last, double remote_probability) noexcept {
+        if (first >= last || remote_probability >= 1.0) {
+            local_size_ = 0;
+            return;
+        }
+        local_first_ = static_cast<std::uint32_t>(first);
+        local_size_ = static_cast<std::uint32_t>(last - first);
+        remote_threshold_ = static_cast<std::uint32_t>(std::max(0.0, remote_probability) * 4294967296.0);
+    }
+
+    inline std::size_t operator()() {
+        auto const bits = draw64(gen_);
+        if (local_size_ != 0 && static_cast<std::uint32_t>(bits >> 32) >= remote_threshold_) {
+            return local_first_ + reduce(static_cast<std::uint32_t>(bits), local_size_);
+        }
+        return reduce(static_cast<std::uint32_t>(bits), size_);
+    }
+
+    inline void operator()(std::size_t &first, std::size_t &second) {
+        if (local_size_ != 0) {
+            first = (*this)();
+            second = (*this)();
+            return;
+        }
+        auto const bits = draw64(gen_);
+        first = reduce(static_cast<std::uint32_t>(bits), size_);
+        second = reduce(static_cast<std::uint32_t>(bits >> 32), size_);
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_RANDOM_HPP_INCLUDED
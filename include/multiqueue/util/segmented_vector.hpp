@@ -0,0 +1,313 @@
+/**
+******************************************************************************
+* @file:   segmented_vector.hpp
+*
+* @brief:  Vector-like container in fixed-size blocks that never moves elements
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_SEGMENTED_VECTOR_HPP_INCLUDED
+#define UTIL_SEGMENTED_VECTOR_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace multiqueue {
+namespace util {
+
+template <typename Container>
+class segmented_vector_iterator {
+    Container const *container_ = nullptr;
+    std::size_t pos_ = 0;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Container::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type const &;
+    using pointer = value_type const *;
+
+    segmented_vector_iterator() = default;
+
+    segmented_vector_iterator(Container const *container, std::size_t pos) noexcept
+        : container_{container}, pos_{pos} {
+    }
+
+    reference operator*() const noexcept {
+        return (*container_)[pos_];
+    }
+
+    pointer operator->() const noexcept {
+        return &(*container_)[pos_];
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return (*container_)[static_cast<std::size_t>(static_cast<difference_type>(pos_) + n)];
+    }
+
+    segmented_vector_iterator &operator++() noexcept {
+        ++pos_;
+        return *this;
+    }
+
+    segmented_vector_iterator operator++(int) noexcept {
+        auto tmp = *this;
+        ++pos_;
+        return tmp;
+    }
+
+    segmented_vector_iterator &operator--() noexcept {
+        --pos_;
+        return *this;
+    }
+
+    segmented_vector_iterator operator--(int) noexcept {
+        auto tmp = *this;
+        --pos_;
+        return tmp;
+    }
+
+    segmented_vector_iterator &operator+=(difference_type n) noexcept {
+        pos_ = static_cast<std::size_t>(static_cast<difference_type>(pos_) + n);
+        return *this;
+    }
+
+    segmented_vector_iterator &operator-=(difference_type n) noexcept {
+        return *this += -n;
+    }
+
+    friend segmented_vector_iterator operator+(segmented_vector_iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend segmented_vector_iterator operator+(difference_type n, segmented_vector_iterator it) noexcept {
+        return it += n;
+    }
+
+    friend segmented_vector_iterator operator-(segmented_vector_iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(segmented_vector_iterator const &lhs,
+                                     segmented_vector_iterator const &rhs) noexcept {
+        return static_cast<difference_type>(lhs.pos_) - static_cast<difference_type>(rhs.pos_);
+    }
+
+    friend bool operator==(segmented_vector_iterator const &lhs, segmented_vector_iterator const &rhs) noexcept {
+        return lhs.pos_ == rhs.pos_;
+    }
+
+    friend bool operator!=(segmented_vector_iterator const &lhs, segmented_vector_iterator const &rhs) noexcept {
+        return lhs.pos_ != rhs.pos_;
+    }
+
+    friend bool operator<(segmented_vector_iterator const &lhs, segmented_vector_iterator const &rhs) noexcept {
+        return lhs.pos_ < rhs.pos_;
+    }
+
+    friend bool operator>(segmented_vector_iterator const &lhs, segmented_vector_iterator const &rhs) noexcept {
+        return lhs.pos_ > rhs.pos_;
+    }
+
+    friend bool operator<=(segmented_vector_iterator const &lhs, segmented_vector_iterator const &rhs) noexcept {
+        return lhs.pos_ <= rhs.pos_;
+    }
+
+    friend bool operator>=(segmented_vector_iterator const &lhs, segmented_vector_iterator const &rhs) noexcept {
+        return lhs.pos_ >= rhs.pos_;
+    }
+};
+
+// Stores the elements in blocks of `BlockSize` elements, which are addressed through a table of block pointers.
+// Growing allocates one block at a time and never moves elements, so the cost of a push is bounded by allocating a
+// block instead of copying all elements as a reallocating vector does. Blocks are kept when elements are removed.
+template <typename T, std::size_t BlockSize, typename Allocator = std::allocator<T>>
+class segmented_vector {
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "BlockSize must be a power of two");
+
+   public:
+    using value_type = T;
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = segmented_vector_iterator<segmented_vector>;
+    using const_iterator = segmented_vector_iterator<segmented_vector>;
+
+   private:
+    using alloc_traits = std::allocator_traits<allocator_type>;
+    using pointer = typename alloc_traits::pointer;
+
+    static constexpr size_type block_shift = static_cast<size_type>(__builtin_ctzll(BlockSize));
+    static constexpr size_type block_mask = BlockSize - 1;
+
+    allocator_type alloc_;
+    std::vector<pointer> blocks_;
+    size_type size_ = 0;
+
+    void add_block() {
+        blocks_.push_back(alloc_traits::allocate(alloc_, BlockSize));
+    }
+
+    void destroy_all() noexcept {
+        clear();
+        for (auto block : blocks_) {
+            alloc_traits::deallocate(alloc_, block, BlockSize);
+        }
+        blocks_.clear();
+    }
+
+   public:
+    segmented_vector() = default;
+
+    explicit segmented_vector(Allocator const &alloc) : alloc_(alloc) {
+    }
+
+    segmented_vector(segmented_vector const &other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+        reserve(other.size_);
+        for (size_type i = 0; i < other.size_; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    segmented_vector(segmented_vector &&other) noexcept
+        : alloc_(std::move(other.alloc_)), blocks_(std::move(other.blocks_)), size_{other.size_} {
+        other.blocks_.clear();
+        other.size_ = 0;
+    }
+
+    segmented_vector &operator=(segmented_vector other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~segmented_vector() noexcept {
+        destroy_all();
+    }
+
+    void swap(segmented_vector &other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap(blocks_, other.blocks_);
+        swap(size_, other.size_);
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return alloc_;
+    }
+
+    inline reference operator[](size_type i) noexcept {
+        assert(i < size_);
+        return blocks_[i >> block_shift][i & block_mask];
+    }
+
+    inline const_reference operator[](size_type i) const noexcept {
+        assert(i < size_);
+        return blocks_[i >> block_shift][i & block_mask];
+    }
+
+    inline reference front() noexcept {
+        return (*this)[0];
+    }
+
+    inline const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    inline reference back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    inline const_reference back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    inline const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    inline const_iterator cbegin() const noexcept {
+        return {this, 0};
+    }
+
+    inline const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    inline const_iterator cend() const noexcept {
+        return {this, size_};
+    }
+
+    [[nodiscard]] inline bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    inline size_type size() const noexcept {
+        return size_;
+    }
+
+    inline size_type capacity() const noexcept {
+        return blocks_.size() * BlockSize;
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args &&...args) {
+        if (size_ == capacity()) {
+            add_block();
+        }
+        auto p = blocks_[size_ >> block_shift] + (size_ & block_mask);
+        alloc_traits::construct(alloc_, std::addressof(*p), std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    inline void push_back(T const &value) {
+        emplace_back(value);
+    }
+
+    inline void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    inline void pop_back() noexcept {
+        assert(size_ > 0);
+        --size_;
+        alloc_traits::destroy(alloc_, std::addressof(blocks_[size_ >> block_shift][size_ & block_mask]));
+    }
+
+    // Allocates blocks for at least `cap` elements
+    void reserve(size_type cap) {
+        auto const num_blocks = (cap + BlockSize - 1) >> block_shift;
+        blocks_.reserve(num_blocks);
+        while (blocks_.size() < num_blocks) {
+            add_block();
+        }
+    }
+
+    void resize(size_type n) {
+        reserve(n);
+        while (size_ < n) {
+            emplace_back();
+        }
+        while (size_ > n) {
+            pop_back();
+        }
+    }
+
+    void clear() noexcept {
+        while (size_ > 0) {
+            pop_back();
+        }
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_SEGMENTED_VECTOR_HPP_INCLUDED
@@ -0,0 +1,86 @@
+/**
+******************************************************************************
+* @file:   seqlock.hpp
+*
+* @brief:  Sequence lock for optimistic reads of small trivially copyable values
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_SEQLOCK_HPP_INCLUDED
+#define UTIL_SEQLOCK_HPP_INCLUDED
+
+#include "multiqueue/util/backoff.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace multiqueue {
+namespace util {
+
+// Stores a copy of a value that is written by at most one thread at a time (e.g. while holding a lock) and can be read
+// by any thread without locking. The value is copied word-wise into atomics, so concurrent reads are well-defined and
+// only retried if a write was in progress.
+template <typename T>
+class seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(std::is_default_constructible_v<T>, "T must be default-constructible");
+
+    using word_type = std::uint64_t;
+    static constexpr std::size_t num_words = (sizeof(T) + sizeof(word_type) - 1) / sizeof(word_type);
+
+    std::atomic<std::uint32_t> version_{0};
+    std::array<std::atomic<word_type>, num_words> words_;
+
+   public:
+    seqlock() noexcept {
+        store(T{});
+    }
+
+    explicit seqlock(T const &value) noexcept {
+        store(value);
+    }
+
+    seqlock(seqlock const &) = delete;
+    seqlock &operator=(seqlock const &) = delete;
+
+    void store(T const &value) noexcept {
+        std::array<word_type, num_words> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+        auto const version = version_.load(std::memory_order_relaxed);
+        version_.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < num_words; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        version_.store(version + 2, std::memory_order_release);
+    }
+
+    T load() const noexcept {
+        std::array<word_type, num_words> buffer;
+        while (true) {
+            auto const version = version_.load(std::memory_order_acquire);
+            if (version % 2 == 0) {
+                for (std::size_t i = 0; i < num_words; ++i) {
+                    buffer[i] = words_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (version_.load(std::memory_order_relaxed) == version) {
+                    break;
+                }
+            }
+            cpu_relax();
+        }
+        T value;
+        std::memcpy(static_cast<void *>(&value), buffer.data(), sizeof(T));
+        return value;
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_SEQLOCK_HPP_INCLUDED
@@ -0,0 +1,162 @@
+/**
+******************************************************************************
+* @file:   stats.hpp
+*
+* @brief:  Per-handle operation counters that compile to nothing if disabled
+*******************************************************************************
+**/
+#pragma once
+#ifndef UTIL_STATS_HPP_INCLUDED
+#define UTIL_STATS_HPP_INCLUDED
+
+#include "system_config.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace multiqueue {
+namespace util {
+
+enum class counter : std::size_t {
+    // Elements pushed
+    pushes,
+    // Elements extracted
+    extractions,
+    // Extractions that found all sampled queues empty
+    empty_extractions,
+    // Failed attempts to lock a queue
+    lock_failures,
+    // Backoffs before sampling again after a failed attempt
+    retries,
+    // Deletion buffers refilled from the insertion buffer and heap
+    deletion_buffer_refills,
+    // Insertion buffers moved into the heap
+    insertion_buffer_flushes,
+    // Elements extracted from a heap
+    heap_pops,
+    // Levels of the heap below the root at these extractions, bounding the levels sifted through
+    sift_levels,
+    // Nodes extracted from a merge heap
+    merge_node_pops,
+    count
+};
+
+inline constexpr std::size_t num_counters = static_cast<std::size_t>(counter::count);
+
+// Snapshot of the counters of one or more handles
+struct operation_stats {
+    std::array<std::uint64_t, num_counters> values{};
+
+    inline std::uint64_t operator[](counter c) const noexcept {
+        return values[static_cast<std::size_t>(c)];
+    }
+
+    // Average number of backoffs per push or extraction
+    double retries_per_operation() const noexcept {
+        auto const operations = (*this)[counter::pushes] + (*this)[counter::extractions] +
+            (*this)[counter::empty_extractions];
+        return operations == 0 ? 0.0 : static_cast<double>((*this)[counter::retries]) / static_cast<double>(operations);
+    }
+
+    operation_stats &operator+=(operation_stats const &other) noexcept {
+        for (std::size_t i = 0; i < num_counters; ++i) {
+            values[i] += other.values[i];
+        }
+        return *this;
+    }
+};
+
+// Number of levels below the root of a `Degree`-ary heap with `size` elements
+template <unsigned int Degree>
+[[gnu::const]] inline std::uint64_t heap_levels(std::size_t size) noexcept {
+    std::uint64_t levels = 0;
+    for (std::size_t i = size > 0 ? size - 1 : 0; i > 0; i = (i - 1) / Degree) {
+        ++levels;
+    }
+    return levels;
+}
+
+// Counters of a local queue, only modified while holding its lock. The lock holder moves them to its own counters
+// before unlocking, so that queues do not need atomic counters.
+template <bool Enabled>
+struct queue_counters {
+    std::array<std::uint64_t, num_counters> values{};
+
+    inline void add(counter c, std::uint64_t n = 1) noexcept {
+        values[static_cast<std::size_t>(c)] += n;
+    }
+};
+
+template <>
+struct queue_counters<false> {
+    inline void add(counter, std::uint64_t = 1) noexcept {
+    }
+};
+
+// Each handle counts into its own cache lines. Only the owning handle writes them, so relaxed loads and stores suffice
+// and the counters can be read while the queue is in use.
+template <bool Enabled>
+class stats_collector {
+    struct alignas(2 * L1_CACHE_LINESIZE) HandleCounters {
+        std::array<std::atomic_uint64_t, num_counters> values{};
+    };
+
+    std::unique_ptr<HandleCounters[]> counters_;
+    unsigned int num_handles_;
+
+   public:
+    explicit stats_collector(unsigned int num_handles)
+        : counters_(new HandleCounters[num_handles]), num_handles_{num_handles} {
+    }
+
+    inline void add(unsigned int id, counter c, std::uint64_t n = 1) noexcept {
+        auto &value = counters_[id].values[static_cast<std::size_t>(c)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    inline void take(unsigned int id, queue_counters<true> &queue) noexcept {
+        for (std::size_t i = 0; i < num_counters; ++i) {
+            if (queue.values[i] != 0) {
+                add(id, static_cast<counter>(i), queue.values[i]);
+                queue.values[i] = 0;
+            }
+        }
+    }
+
+    operation_stats get(unsigned int id) const noexcept {
+        operation_stats stats;
+        for (std::size_t i = 0; i < num_counters; ++i) {
+            stats.values[i] = counters_[id].values[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    operation_stats get() const noexcept {
+        operation_stats stats;
+        for (unsigned int i = 0; i < num_handles_; ++i) {
+            stats += get(i);
+        }
+        return stats;
+    }
+};
+
+template <>
+class stats_collector<false> {
+   public:
+    explicit stats_collector(unsigned int) noexcept {
+    }
+
+    inline void add(unsigned int, counter, std::uint64_t = 1) noexcept {
+    }
+
+    inline void take(unsigned int, queue_counters<false> &) noexcept {
+    }
+};
+
+}  // namespace util
+}  // namespace multiqueue
+
+#endif  //! UTIL_STATS_HPP_INCLUDED
@@ -0,0 +1,79 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/backoff.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+static constexpr int ops_per_thread = 10'000;
+
+template <typename BackoffPolicy>
+struct WithBackoff : multiqueue::configuration::Default {
+    using Backoff = BackoffPolicy;
+    // Each thread holds only a few elements at a time
+    static constexpr std::size_t ReservePerQueue = 1 << 10;
+};
+
+TEMPLATE_TEST_CASE("Backoff oversubscribed", "[benchmark][backoff]", multiqueue::util::backoff::None,
+                   multiqueue::util::backoff::Pause, multiqueue::util::backoff::Exponential<>,
+                   multiqueue::util::backoff::Yield<>) {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, WithBackoff<TestType>>;
+
+    // More threads than cores, so lock holders get preempted
+    unsigned int const num_threads = 4 * std::max(1u, std::thread::hardware_concurrency());
+
+    // The queue and the threads are set up outside of the timed region. Each measured run starts a new round, in which
+    // every thread performs its operations once.
+    BENCHMARK_ADVANCED("push_extract")(Catch::Benchmark::Chronometer meter) {
+        auto pq = multiqueue_t{num_threads};
+        std::atomic_int round{0};
+        std::atomic_uint finished{0};
+        std::atomic_bool stop{false};
+        std::atomic_int extracted{0};
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (unsigned int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                auto handle = pq.get_handle(t);
+                typename multiqueue_t::value_type retval;
+                for (int done = 0;; ++done) {
+                    while (round.load(std::memory_order_acquire) == done) {
+                        if (stop.load(std::memory_order_acquire)) {
+                            return;
+                        }
+                        std::this_thread::yield();
+                    }
+                    int count = 0;
+                    for (int i = 0; i < ops_per_thread; ++i) {
+                        pq.push(handle, {static_cast<int>(t) * ops_per_thread + i, i});
+                        if (pq.extract_top(handle, retval)) {
+                            ++count;
+                        }
+                    }
+                    extracted.fetch_add(count, std::memory_order_relaxed);
+                    finished.fetch_add(1, std::memory_order_acq_rel);
+                }
+            });
+        }
+        meter.measure([&] {
+            finished.store(0, std::memory_order_relaxed);
+            round.fetch_add(1, std::memory_order_acq_rel);
+            while (finished.load(std::memory_order_acquire) != num_threads) {
+                std::this_thread::yield();
+            }
+            // to guarantee computation
+            return extracted.load(std::memory_order_relaxed);
+        });
+        stop.store(true, std::memory_order_release);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    };
+}
@@ -0,0 +1,47 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+
+#include "extract_all.hpp"
+#include "rank_error.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t num_elements = 1 << 18;
+
+template <std::size_t CacheSize>
+struct WithDeletionCache : multiqueue::configuration::Default {
+    static constexpr std::size_t DeletionCacheSize = CacheSize;
+    static constexpr std::size_t ReservePerQueue = 1 << 16;
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Deletion cache", "[benchmark][deletion_cache]", WithDeletionCache<0>, WithDeletionCache<4>,
+                   WithDeletionCache<16>, WithDeletionCache<64>) {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>;
+    unsigned int const num_threads = std::max(2u, std::thread::hardware_concurrency());
+
+    {
+        auto pq = multiqueue_t{num_threads};
+        prefill(pq, num_threads, num_elements);
+        auto const logs = extract_all_logged(pq, num_threads);
+        auto const stats = pq.get_deletion_cache_stats();
+        std::cout << "cache size " << TestType::DeletionCacheSize << ": average rank error "
+                  << average_rank_error(logs, num_elements) << ", served " << stats.served << ", refills "
+                  << stats.refills << ", beaten " << stats.beaten << ", returned " << stats.returned << '\n';
+    }
+
+    BENCHMARK_ADVANCED("extract_all")(Catch::Benchmark::Chronometer meter) {
+        measure_extract_all<multiqueue_t>(meter, num_threads, num_elements);
+    };
+}
@@ -0,0 +1,134 @@
+#include "multiqueue/addressable_multiqueue.hpp"
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "graph.hpp"
+#include "sssp.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t num_nodes = 1 << 16;
+constexpr std::uint32_t avg_degree = 8;
+constexpr std::uint32_t max_weight = 100;
+
+// Random graph with uniform edge weights, where each node also has an edge to its successor to keep it connected
+Graph generate_graph() {
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<std::uint32_t> node_dist(0, num_nodes - 1);
+    std::uniform_int_distribution<std::uint32_t> weight_dist(1, max_weight);
+    Graph graph;
+    graph.first_edge.reserve(num_nodes + 1);
+    for (std::uint32_t u = 0; u < num_nodes; ++u) {
+        graph.first_edge.push_back(static_cast<std::uint32_t>(graph.target.size()));
+        graph.target.push_back((u + 1) % num_nodes);
+        graph.weight.push_back(weight_dist(gen));
+        for (std::uint32_t i = 1; i < avg_degree; ++i) {
+            graph.target.push_back(node_dist(gen));
+            graph.weight.push_back(weight_dist(gen));
+        }
+    }
+    graph.first_edge.push_back(static_cast<std::uint32_t>(graph.target.size()));
+    return graph;
+}
+
+// Runs `work(id)` on `num_threads` threads
+template <typename Work>
+void run_parallel(unsigned int num_threads, Work work) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back(work, t);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Dijkstra", "[benchmark][dijkstra]") {
+    auto const graph = generate_graph();
+    unsigned int const num_threads = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+    std::vector<std::atomic_uint32_t> dist(num_nodes);
+
+    auto reset = [&dist]() {
+        for (auto &d : dist) {
+            d.store(unreachable, std::memory_order_relaxed);
+        }
+        dist[0].store(0, std::memory_order_relaxed);
+    };
+
+    BENCHMARK("lazy_reinsertion") {
+        using multiqueue_t = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>,
+                                                    multiqueue::configuration::NoBuffering>;
+        reset();
+        auto pq = multiqueue_t{num_threads};
+        // Number of pushed elements that have not been processed yet
+        std::atomic_int pending{1};
+        pq.push(pq.get_handle(0), {0, 0});
+        run_parallel(num_threads, [&](unsigned int id) {
+            auto handle = pq.get_handle(id);
+            typename multiqueue_t::value_type top;
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!pq.extract_top(handle, top)) {
+                    continue;
+                }
+                auto const u = top.second;
+                if (top.first == dist[u].load(std::memory_order_relaxed)) {
+                    for (auto e = graph.first_edge[u]; e < graph.first_edge[u + 1]; ++e) {
+                        auto const d = top.first + graph.weight[e];
+                        if (relax(dist[graph.target[e]], d)) {
+                            pending.fetch_add(1, std::memory_order_relaxed);
+                            pq.push(handle, {d, graph.target[e]});
+                        }
+                    }
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+        });
+        return dist[num_nodes - 1].load();
+    };
+
+    BENCHMARK("decrease_key") {
+        using multiqueue_t = multiqueue::addressable_multiqueue<std::uint32_t, std::uint32_t>;
+        reset();
+        auto pq = multiqueue_t{num_threads};
+        std::vector<typename multiqueue_t::locator> locators(num_nodes);
+        std::atomic_int pending{1};
+        pq.push(pq.get_handle(0), locators[0], 0, 0);
+        run_parallel(num_threads, [&](unsigned int id) {
+            auto handle = pq.get_handle(id);
+            typename multiqueue_t::value_type top;
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!pq.extract_top(handle, top)) {
+                    continue;
+                }
+                auto const u = top.second;
+                for (auto e = graph.first_edge[u]; e < graph.first_edge[u + 1]; ++e) {
+                    auto const v = graph.target[e];
+                    auto const d = top.first + graph.weight[e];
+                    if (relax(dist[v], d)) {
+                        // Count before pushing, as another thread might process the element immediately
+                        pending.fetch_add(1, std::memory_order_relaxed);
+                        if (!pq.push_or_decrease_key(handle, locators[v], d, v)) {
+                            pending.fetch_sub(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+        });
+        return dist[num_nodes - 1].load();
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef MICRO_BENCHMARKS_EXTRACT_ALL_HPP_INCLUDED
+#define MICRO_BENCHMARKS_EXTRACT_ALL_HPP_INCLUDED
+
+#include "rank_error.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Called by every thread with its handle before it extracts
+struct no_setup {
+    template <typename MultiQueue, typename Handle>
+    void operator()(MultiQueue & /*pq*/, Handle /*handle*/, unsigned int /*id*/) const noexcept {
+    }
+};
+
+// Fills the queue with the keys [0, num_elements) in random order, using all handles
+template <typename MultiQueue>
+void prefill(MultiQueue &pq, unsigned int num_threads, std::uint32_t num_elements) {
+    std::vector<std::uint32_t> keys(num_elements);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937{0});
+    for (std::uint32_t i = 0; i < num_elements; ++i) {
+        pq.push(pq.get_handle(i % num_threads), {keys[i], keys[i]});
+    }
+}
+
+// Extracts on all threads until each of them finds the queue empty and returns the extractions of every thread
+template <typename MultiQueue, typename Setup = no_setup>
+std::vector<extraction_log> extract_all_logged(MultiQueue &pq, unsigned int num_threads, Setup setup = {}) {
+    std::vector<extraction_log> logs(num_threads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&pq, &logs, &setup, t]() {
+            auto handle = pq.get_handle(t);
+            setup(pq, handle, t);
+            typename MultiQueue::value_type retval;
+            while (pq.extract_top(handle, retval)) {
+                log_extraction(logs[t], retval.first);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return logs;
+}
+
+// Times extracting on all threads until each of them finds the queue empty. The queues are constructed and
+// prefilled and the threads are started outside of the timed region. Each measured run empties its own queue.
+template <typename MultiQueue, typename Setup = no_setup>
+void measure_extract_all(Catch::Benchmark::Chronometer meter, unsigned int num_threads, std::uint32_t num_elements,
+                         Setup setup = {}) {
+    int const runs = meter.runs();
+    std::vector<std::unique_ptr<MultiQueue>> queues;
+    queues.reserve(static_cast<std::size_t>(runs));
+    for (int r = 0; r < runs; ++r) {
+        queues.push_back(std::make_unique<MultiQueue>(num_threads));
+        prefill(*queues.back(), num_threads, num_elements);
+    }
+    std::atomic_int round{0};
+    std::atomic_uint finished{0};
+    std::atomic_uint32_t extracted{0};
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (auto &pq : queues) {
+                setup(*pq, pq->get_handle(t), t);
+            }
+            typename MultiQueue::value_type retval;
+            for (int r = 0; r < runs; ++r) {
+                while (round.load(std::memory_order_acquire) == r) {
+                    std::this_thread::yield();
+                }
+                auto &pq = *queues[static_cast<std::size_t>(r)];
+                auto handle = pq.get_handle(t);
+                std::uint32_t count = 0;
+                while (pq.extract_top(handle, retval)) {
+                    ++count;
+                }
+                extracted.fetch_add(count, std::memory_order_relaxed);
+                finished.fetch_add(1, std::memory_order_acq_rel);
+            }
+        });
+    }
+    meter.measure([&](int r) {
+        finished.store(0, std::memory_order_relaxed);
+        round.store(r + 1, std::memory_order_release);
+        while (finished.load(std::memory_order_acquire) != num_threads) {
+            std::this_thread::yield();
+        }
+        // to guarantee computation
+        return extracted.load(std::memory_order_relaxed);
+    });
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+#endif  //! MICRO_BENCHMARKS_EXTRACT_ALL_HPP_INCLUDED
@@ -0,0 +1,206 @@
+#pragma once
+#ifndef MICRO_BENCHMARKS_GRAPH_HPP_INCLUDED
+#define MICRO_BENCHMARKS_GRAPH_HPP_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Directed graph with edge weights in compressed sparse row format. The edges of node `u` are in
+// [first_edge[u], first_edge[u + 1]).
+struct Graph {
+    std::vector<std::uint32_t> first_edge;
+    std::vector<std::uint32_t> target;
+    std::vector<std::uint32_t> weight;
+
+    std::uint32_t num_nodes() const noexcept {
+        return first_edge.empty() ? 0 : static_cast<std::uint32_t>(first_edge.size() - 1);
+    }
+
+    std::size_t num_edges() const noexcept {
+        return target.size();
+    }
+};
+
+struct Edge {
+    std::uint32_t source;
+    std::uint32_t target;
+    std::uint32_t weight;
+};
+
+// Sorts the edges by source with a counting sort
+inline Graph build_graph(std::uint32_t num_nodes, std::vector<Edge> const &edges) {
+    Graph graph;
+    graph.first_edge.assign(num_nodes + 1, 0);
+    for (auto const &e : edges) {
+        ++graph.first_edge[e.source + 1];
+    }
+    for (std::uint32_t u = 0; u < num_nodes; ++u) {
+        graph.first_edge[u + 1] += graph.first_edge[u];
+    }
+    graph.target.resize(edges.size());
+    graph.weight.resize(edges.size());
+    std::vector<std::uint32_t> pos(graph.first_edge.begin(), graph.first_edge.end() - 1);
+    for (auto const &e : edges) {
+        auto const i = pos[e.source]++;
+        graph.target[i] = e.target;
+        graph.weight[i] = e.weight;
+    }
+    return graph;
+}
+
+// Reads a graph in the format of the 9th DIMACS implementation challenge, with nodes numbered from 1
+inline Graph read_dimacs(std::string const &path) {
+    std::ifstream in{path};
+    if (!in) {
+        throw std::runtime_error{"Could not open " + path};
+    }
+    std::uint32_t num_nodes = 0;
+    std::vector<Edge> edges;
+    for (std::string line; std::getline(in, line);) {
+        std::istringstream ss{line};
+        char type;
+        if (!(ss >> type)) {
+            continue;
+        }
+        if (type == 'p') {
+            std::string format;
+            std::size_t num_edges;
+            ss >> format >> num_nodes >> num_edges;
+            edges.reserve(num_edges);
+        } else if (type == 'a') {
+            Edge e;
+            ss >> e.source >> e.target >> e.weight;
+            if (!ss || e.source == 0 || e.target == 0 || e.source > num_nodes || e.target > num_nodes) {
+                throw std::runtime_error{"Invalid arc in " + path + ": " + line};
+            }
+            --e.source;
+            --e.target;
+            edges.push_back(e);
+        }
+    }
+    return build_graph(num_nodes, edges);
+}
+
+// Reads lines of `source target [weight]` with nodes numbered from 0 and a default weight of 1. Lines starting with
+// '#' or '%' are comments.
+inline Graph read_edge_list(std::string const &path) {
+    std::ifstream in{path};
+    if (!in) {
+        throw std::runtime_error{"Could not open " + path};
+    }
+    std::uint32_t num_nodes = 0;
+    std::vector<Edge> edges;
+    for (std::string line; std::getline(in, line);) {
+        if (line.empty() || line[0] == '#' || line[0] == '%') {
+            continue;
+        }
+        std::istringstream ss{line};
+        Edge e{0, 0, 1};
+        if (!(ss >> e.source >> e.target)) {
+            throw std::runtime_error{"Invalid edge in " + path + ": " + line};
+        }
+        ss >> e.weight;
+        num_nodes = std::max({num_nodes, e.source + 1, e.target + 1});
+        edges.push_back(e);
+    }
+    return build_graph(num_nodes, edges);
+}
+
+// Files ending in ".gr" are read as DIMACS graphs, all others as edge lists
+inline Graph read_graph(std::string const &path) {
+    if (path.size() >= 3 && path.compare(path.size() - 3, 3, ".gr") == 0) {
+        return read_dimacs(path);
+    }
+    return read_edge_list(path);
+}
+
+// Grid where each node is connected to its four neighbors in both directions, like a road network without
+// long-distance edges
+inline Graph generate_grid(std::uint32_t rows, std::uint32_t cols, std::uint32_t max_weight, std::uint64_t seed = 0) {
+    std::mt19937_64 gen{seed};
+    std::uniform_int_distribution<std::uint32_t> weight_dist(1, max_weight);
+    std::vector<Edge> edges;
+    edges.reserve(4 * static_cast<std::size_t>(rows) * cols);
+    for (std::uint32_t r = 0; r < rows; ++r) {
+        for (std::uint32_t c = 0; c < cols; ++c) {
+            auto const u = r * cols + c;
+            if (c + 1 < cols) {
+                auto const w = weight_dist(gen);
+                edges.push_back({u, u + 1, w});
+                edges.push_back({u + 1, u, w});
+            }
+            if (r + 1 < rows) {
+                auto const w = weight_dist(gen);
+                edges.push_back({u, u + cols, w});
+                edges.push_back({u + cols, u, w});
+            }
+        }
+    }
+    return build_graph(rows * cols, edges);
+}
+
+// Random points in the unit square, connected in both directions if their distance is at most `radius`. The weight
+// is the distance scaled by `scale`. Points are bucketed into cells of width `radius` to find close pairs.
+inline Graph generate_geometric(std::uint32_t num_nodes, double radius, double scale = 1e6, std::uint64_t seed = 0) {
+    std::mt19937_64 gen{seed};
+    std::uniform_real_distribution<double> coord_dist(0.0, 1.0);
+    std::vector<std::pair<double, double>> points(num_nodes);
+    for (auto &p : points) {
+        p = {coord_dist(gen), coord_dist(gen)};
+    }
+    auto const cells = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(1.0 / radius));
+    auto cell_of = [cells](double x) { return std::min(cells - 1, static_cast<std::uint32_t>(x * cells)); };
+    std::vector<std::vector<std::uint32_t>> grid(static_cast<std::size_t>(cells) * cells);
+    for (std::uint32_t u = 0; u < num_nodes; ++u) {
+        grid[cell_of(points[u].first) * cells + cell_of(points[u].second)].push_back(u);
+    }
+    std::vector<Edge> edges;
+    for (std::uint32_t u = 0; u < num_nodes; ++u) {
+        auto const cx = cell_of(points[u].first);
+        auto const cy = cell_of(points[u].second);
+        for (auto x = cx > 0 ? cx - 1 : 0; x <= std::min(cells - 1, cx + 1); ++x) {
+            for (auto y = cy > 0 ? cy - 1 : 0; y <= std::min(cells - 1, cy + 1); ++y) {
+                for (auto v : grid[x * cells + y]) {
+                    auto const d = std::hypot(points[u].first - points[v].first, points[u].second - points[v].second);
+                    if (v != u && d <= radius) {
+                        edges.push_back({u, v, std::max(1u, static_cast<std::uint32_t>(d * scale))});
+                    }
+                }
+            }
+        }
+    }
+    return build_graph(num_nodes, edges);
+}
+
+// Recursive matrix graph with 2^`scale` nodes and `edge_factor` edges per node on average. Each edge recursively
+// chooses one of the quadrants of the adjacency matrix with probabilities a, b, c and 1 - a - b - c, which results in
+// a skewed degree distribution similar to social networks.
+inline Graph generate_rmat(unsigned int scale, std::uint32_t edge_factor, std::uint32_t max_weight,
+                           std::uint64_t seed = 0, double a = 0.57, double b = 0.19, double c = 0.19) {
+    std::mt19937_64 gen{seed};
+    std::uniform_real_distribution<double> quadrant_dist(0.0, 1.0);
+    std::uniform_int_distribution<std::uint32_t> weight_dist(1, max_weight);
+    std::uint32_t const num_nodes = std::uint32_t{1} << scale;
+    std::vector<Edge> edges(static_cast<std::size_t>(num_nodes) * edge_factor);
+    for (auto &e : edges) {
+        std::uint32_t u = 0;
+        std::uint32_t v = 0;
+        for (unsigned int level = 0; level < scale; ++level) {
+            auto const p = quadrant_dist(gen);
+            u = 2 * u + (p >= a + b ? 1 : 0);
+            v = 2 * v + ((p >= a && p < a + b) || p >= a + b + c ? 1 : 0);
+        }
+        e = {u, v, weight_dist(gen)};
+    }
+    return build_graph(num_nodes, edges);
+}
+
+#endif  //! MICRO_BENCHMARKS_GRAPH_HPP_INCLUDED
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef MICRO_BENCHMARKS_HDR_HISTOGRAM_HPP_INCLUDED
+#define MICRO_BENCHMARKS_HDR_HISTOGRAM_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Log-linear histogram like HdrHistogram: values below 2^`SubBucketBits` are counted exactly, larger values in
+// 2^`SubBucketBits` equally sized buckets per power of two, which bounds the relative error by 2^-`SubBucketBits`.
+template <unsigned int SubBucketBits = 7>
+class hdr_histogram {
+    static constexpr std::uint64_t sub_buckets = std::uint64_t{1} << SubBucketBits;
+    static constexpr std::size_t num_buckets = (65 - SubBucketBits) * sub_buckets;
+
+    std::vector<std::uint64_t> counts_ = std::vector<std::uint64_t>(num_buckets, 0);
+    std::uint64_t total_ = 0;
+    std::uint64_t max_ = 0;
+
+    static inline std::size_t index(std::uint64_t value) noexcept {
+        if (value < sub_buckets) {
+            return static_cast<std::size_t>(value);
+        }
+        auto const shift = static_cast<unsigned int>(63 - __builtin_clzll(value)) - SubBucketBits;
+        return static_cast<std::size_t>((shift + 1) * sub_buckets + ((value >> shift) - sub_buckets));
+    }
+
+    // Largest value counted in bucket `i`
+    static inline std::uint64_t upper_bound(std::size_t i) noexcept {
+        if (i < sub_buckets) {
+            return i;
+        }
+        auto const shift = i / sub_buckets - 1;
+        auto const sub = i % sub_buckets + sub_buckets;
+        return ((sub + 1) << shift) - 1;
+    }
+
+   public:
+    inline void record(std::uint64_t value) noexcept {
+        ++counts_[index(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+    }
+
+    std::uint64_t total() const noexcept {
+        return total_;
+    }
+
+    std::uint64_t max() const noexcept {
+        return max_;
+    }
+
+    // Smallest bucket bound such that at least a fraction of `q` of the values is not larger, zero if empty
+    std::uint64_t quantile(double q) const noexcept {
+        if (total_ == 0) {
+            return 0;
+        }
+        auto const target =
+            std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total_))));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(upper_bound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    hdr_histogram &operator+=(hdr_histogram const &other) noexcept {
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+        return *this;
+    }
+};
+
+// Reads the time stamp counter where available, which is cheaper than a system clock call. Otherwise, the steady
+// clock is used in nanoseconds.
+struct tsc_clock {
+    static inline std::uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        // Keeps the read from being executed before preceding instructions
+        _mm_lfence();
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+#endif
+    }
+
+    // Measures the ticks per nanosecond against the steady clock
+    static double ticks_per_ns(std::chrono::milliseconds duration = std::chrono::milliseconds{50}) {
+        auto const clock_begin = std::chrono::steady_clock::now();
+        auto const tsc_begin = now();
+        std::this_thread::sleep_for(duration);
+        auto const tsc_end = now();
+        auto const clock_end = std::chrono::steady_clock::now();
+        return static_cast<double>(tsc_end - tsc_begin) /
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end - clock_begin).count());
+    }
+};
+
+#endif  //! MICRO_BENCHMARKS_HDR_HISTOGRAM_HPP_INCLUDED
@@ -0,0 +1,244 @@
+// Open-loop latency benchmark of push and extract_top. Each thread issues operations at a fixed rate, alternating
+// between pushes of random keys and extractions. The latency of an operation is measured from the time it was
+// scheduled to be issued instead of the time it was actually issued, so that a stalled operation also accounts for
+// the delay of the operations queued up behind it (no coordinated omission). The service time is measured from the
+// actual issue. Tail percentiles of both are written as CSV per configuration, thread count and operation.
+//
+// Usage: latency [options]
+//   -R <num>   Total operations per second over all threads (default: 1000000)
+//   -d <sec>   Duration of each run in seconds (default: 1)
+//   -p <num>   Elements prefilled per thread (default: 65536)
+//   -t <list>  Thread counts (default: powers of two up to the hardware concurrency)
+//   -f <list>  Frontends: multiqueue, int_multiqueue
+//   -c <list>  Configurations from configurations.hpp
+//   -o <file>  Output file (default: stdout)
+// Lists are comma-separated, omitted lists select everything.
+
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/backoff.hpp"
+
+#include "hdr_histogram.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// The int multiqueue uses the largest key as sentinel
+constexpr std::uint32_t max_key = std::numeric_limits<std::uint32_t>::max() - 1;
+
+struct Settings {
+    double rate = 1e6;
+    double duration = 1.0;
+    std::uint64_t prefill = 1 << 16;
+    std::vector<unsigned int> threads;
+    std::vector<std::string> frontends;
+    std::vector<std::string> configurations;
+    double ticks_per_ns = 1.0;
+};
+
+bool selected(std::vector<std::string> const &list, std::string const &name) {
+    return list.empty() || std::find(list.begin(), list.end(), name) != list.end();
+}
+
+std::vector<std::string> split(std::string const &list) {
+    std::vector<std::string> items;
+    std::stringstream ss{list};
+    for (std::string item; std::getline(ss, item, ',');) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Histograms of one thread in ticks
+struct Histograms {
+    hdr_histogram<> push_latency;
+    hdr_histogram<> push_service;
+    hdr_histogram<> extract_latency;
+    hdr_histogram<> extract_service;
+    std::uint64_t empty_extractions = 0;
+
+    Histograms &operator+=(Histograms const &other) {
+        push_latency += other.push_latency;
+        push_service += other.push_service;
+        extract_latency += other.extract_latency;
+        extract_service += other.extract_service;
+        empty_extractions += other.empty_extractions;
+        return *this;
+    }
+};
+
+template <typename MultiQueue>
+Histograms run(Settings const &settings, unsigned int num_threads) {
+    MultiQueue pq{num_threads};
+    double const rate_per_thread = settings.rate / num_threads;
+    auto const operations = static_cast<std::uint64_t>(rate_per_thread * settings.duration);
+    double const interval = settings.ticks_per_ns * 1e9 / rate_per_thread;
+    std::atomic_uint ready{0};
+    std::atomic_uint64_t start{0};
+    std::vector<Histograms> histograms(num_threads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto handle = pq.get_handle(t);
+            std::mt19937_64 gen{t};
+            std::uniform_int_distribution<std::uint32_t> key_dist{0, max_key};
+            for (std::uint64_t i = 0; i < settings.prefill; ++i) {
+                auto const key = key_dist(gen);
+                pq.push(handle, {key, key});
+            }
+            auto &h = histograms[t];
+            typename MultiQueue::value_type retval;
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            std::uint64_t begin;
+            while ((begin = start.load(std::memory_order_acquire)) == 0) {
+                std::this_thread::yield();
+            }
+            for (std::uint64_t i = 0; i < operations; ++i) {
+                auto const scheduled = begin + static_cast<std::uint64_t>(static_cast<double>(i) * interval);
+                auto issued = tsc_clock::now();
+                while (issued < scheduled) {
+                    multiqueue::util::cpu_relax();
+                    issued = tsc_clock::now();
+                }
+                if (i % 2 == 0) {
+                    auto const key = key_dist(gen);
+                    pq.push(handle, {key, key});
+                    auto const done = tsc_clock::now();
+                    h.push_latency.record(done - scheduled);
+                    h.push_service.record(done - issued);
+                } else {
+                    bool const success = pq.extract_top(handle, retval);
+                    auto const done = tsc_clock::now();
+                    h.extract_latency.record(done - scheduled);
+                    h.extract_service.record(done - issued);
+                    if (!success) {
+                        ++h.empty_extractions;
+                    }
+                }
+            }
+        });
+    }
+    while (ready.load(std::memory_order_acquire) != num_threads) {
+        std::this_thread::yield();
+    }
+    start.store(tsc_clock::now(), std::memory_order_release);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    Histograms sum;
+    for (auto const &h : histograms) {
+        sum += h;
+    }
+    return sum;
+}
+
+void report(std::ostream &out, std::string const &prefix, std::string const &operation, std::string const &metric,
+            hdr_histogram<> const &h, double ticks_per_ns) {
+    auto ns = [ticks_per_ns](std::uint64_t ticks) { return static_cast<double>(ticks) / ticks_per_ns; };
+    out << prefix << ',' << operation << ',' << metric << ',' << h.total() << ',' << ns(h.quantile(0.5)) << ','
+        << ns(h.quantile(0.9)) << ',' << ns(h.quantile(0.99)) << ',' << ns(h.quantile(0.999)) << ','
+        << ns(h.quantile(0.9999)) << ',' << ns(h.max()) << '\n';
+}
+
+template <typename MultiQueue>
+void run_all(Settings const &settings, std::ostream &out, std::string const &frontend,
+             std::string const &configuration) {
+    if (!selected(settings.frontends, frontend) || !selected(settings.configurations, configuration)) {
+        return;
+    }
+    for (auto num_threads : settings.threads) {
+        auto const h = run<MultiQueue>(settings, num_threads);
+        std::stringstream prefix;
+        prefix << frontend << ',' << configuration << ',' << num_threads << ',' << settings.rate;
+        report(out, prefix.str(), "push", "latency", h.push_latency, settings.ticks_per_ns);
+        report(out, prefix.str(), "push", "service", h.push_service, settings.ticks_per_ns);
+        report(out, prefix.str(), "extract_top", "latency", h.extract_latency, settings.ticks_per_ns);
+        report(out, prefix.str(), "extract_top", "service", h.extract_service, settings.ticks_per_ns);
+        if (h.empty_extractions > 0) {
+            std::cerr << frontend << ' ' << configuration << " on " << num_threads << " threads: "
+                      << h.empty_extractions << " extractions found the queue empty\n";
+        }
+        out << std::flush;
+    }
+}
+
+template <typename Configuration>
+using generic_multiqueue =
+    multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, Configuration>;
+
+template <typename Configuration>
+using int_multiqueue = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Configuration>;
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    Settings settings;
+    std::ofstream file;
+    std::ostream *out = &std::cout;
+    for (int i = 1; i < argc; ++i) {
+        std::string const option = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value of option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+        std::string const value = argv[++i];
+        if (option == "-R") {
+            settings.rate = std::stod(value);
+        } else if (option == "-d") {
+            settings.duration = std::stod(value);
+        } else if (option == "-p") {
+            settings.prefill = std::stoull(value);
+        } else if (option == "-t") {
+            for (auto const &t : split(value)) {
+                settings.threads.push_back(static_cast<unsigned int>(std::stoul(t)));
+            }
+        } else if (option == "-f") {
+            settings.frontends = split(value);
+        } else if (option == "-c") {
+            settings.configurations = split(value);
+        } else if (option == "-o") {
+            file.open(value);
+            out = &file;
+        } else {
+            std::cerr << "Unknown option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.threads.empty()) {
+        for (unsigned int t = 1; t <= std::max(1u, std::thread::hardware_concurrency()); t *= 2) {
+            settings.threads.push_back(t);
+        }
+    }
+    settings.ticks_per_ns = tsc_clock::ticks_per_ns();
+
+    namespace config = multiqueue::configuration;
+    *out << "frontend,configuration,threads,rate,operation,metric,count,p50_ns,p90_ns,p99_ns,p999_ns,p9999_ns,max_ns\n";
+    run_all<generic_multiqueue<config::Default>>(settings, *out, "multiqueue", "Default");
+    run_all<generic_multiqueue<config::Merging>>(settings, *out, "multiqueue", "Merging");
+    run_all<generic_multiqueue<config::Staging>>(settings, *out, "multiqueue", "Staging");
+    run_all<generic_multiqueue<config::Segmented>>(settings, *out, "multiqueue", "Segmented");
+    run_all<int_multiqueue<config::Default>>(settings, *out, "int_multiqueue", "Default");
+    run_all<int_multiqueue<config::NoBuffering>>(settings, *out, "int_multiqueue", "NoBuffering");
+    run_all<int_multiqueue<config::Merging>>(settings, *out, "int_multiqueue", "Merging");
+    run_all<int_multiqueue<config::DeletionCache>>(settings, *out, "int_multiqueue", "DeletionCache");
+    run_all<int_multiqueue<config::Combining>>(settings, *out, "int_multiqueue", "Combining");
+    run_all<int_multiqueue<config::AdaptiveStickiness>>(settings, *out, "int_multiqueue", "AdaptiveStickiness");
+    run_all<int_multiqueue<config::Segmented>>(settings, *out, "int_multiqueue", "Segmented");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/numa.hpp"
+
+#include "extract_all.hpp"
+#include "rank_error.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t num_elements = 1 << 18;
+
+template <int RemotePercent>
+struct NumaSampling : multiqueue::configuration::Default {
+    static constexpr bool NumaFriendly = true;
+    static constexpr double NumaRemoteProbability = RemotePercent / 100.0;
+    static constexpr std::size_t ReservePerQueue = 1 << 16;
+};
+
+// Binds the handle to the node of its thread. Without multiple nodes (or numa support), two nodes are emulated by
+// splitting the threads, which exercises the sampling but not the memory placement.
+struct bind_handle {
+    template <typename MultiQueue>
+    void operator()(MultiQueue &pq, typename MultiQueue::Handle handle, unsigned int id) const {
+        if (multiqueue::util::numa_node_count() > 1) {
+            pq.set_numa_node(handle);
+        } else {
+            pq.set_numa_node(handle, id % 2, 2);
+        }
+    }
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Numa local sampling", "[benchmark][numa]", NumaSampling<0>, NumaSampling<10>, NumaSampling<50>,
+                   NumaSampling<100>) {
+    using multiqueue_t = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, TestType>;
+    unsigned int const num_threads = std::max(2u, std::thread::hardware_concurrency());
+
+    {
+        auto pq = multiqueue_t{num_threads};
+        prefill(pq, num_threads, num_elements);
+        auto const logs = extract_all_logged(pq, num_threads, bind_handle{});
+        std::cout << "remote probability " << TestType::NumaRemoteProbability << ": average rank error "
+                  << average_rank_error(logs, num_elements) << '\n';
+    }
+
+    BENCHMARK_ADVANCED("extract_all")(Catch::Benchmark::Chronometer meter) {
+        measure_extract_all<multiqueue_t>(meter, num_threads, num_elements, bind_handle{});
+    };
+}
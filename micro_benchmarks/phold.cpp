@@ -0,0 +1,279 @@
+// PHOLD benchmark of the multiqueue as event queue of a parallel discrete-event simulation. Each of the logical
+// processes (LPs) starts with a number of events. Processing an event at time t schedules `fan-out` events with
+// probability 1 / fan-out at time t + lookahead + an exponentially distributed increment, mostly at a random other LP.
+// The simulation ends when no event before the end time is left. An event is out of order if its LP already
+// processed a later event, which an optimistic simulator would have to roll back. The results are written as CSV with
+// one line per run.
+//
+// Usage: phold [options]
+//   -l <num>    Logical processes (default: 1024)
+//   -e <num>    Initial events per LP (default: 16)
+//   -a <num>    Lookahead in ticks (default: 100)
+//   -m <num>    Mean timestamp increment in ticks beyond the lookahead (default: 1000)
+//   -f <num>    Fan-out (default: 1)
+//   -p <prob>   Probability that an event is scheduled at a random LP instead of its own (default: 0.9)
+//   -x <num>    End time in ticks (default: 1000000)
+//   -w <num>    Pause instructions per processed event to emulate work (default: 0)
+//   -t <list>   Thread counts (default: powers of two up to the hardware concurrency)
+//   -c <list>   Configurations from configurations.hpp, K4 and K16 denote Default with the respective stickiness
+//   -r <num>    Repetitions of each run (default: 1)
+//   -o <file>   Output file (default: stdout)
+// Lists are comma-separated, omitted lists select everything.
+
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/backoff.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Settings {
+    std::uint32_t num_lps = 1024;
+    std::uint32_t events_per_lp = 16;
+    std::uint64_t lookahead = 100;
+    double mean_increment = 1000.0;
+    std::uint32_t fan_out = 1;
+    double remote_probability = 0.9;
+    std::uint64_t end_time = 1'000'000;
+    unsigned int work = 0;
+    std::vector<unsigned int> threads;
+    std::vector<std::string> configurations;
+    unsigned int repetitions = 1;
+};
+
+struct Result {
+    double seconds = 0.0;
+    std::uint64_t events = 0;
+    std::uint64_t out_of_order = 0;
+};
+
+std::vector<std::string> split(std::string const &list) {
+    std::vector<std::string> items;
+    std::stringstream ss{list};
+    for (std::string item; std::getline(ss, item, ',');) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Schedules events generated at time `now`, mostly at random LPs
+class EventGenerator {
+    Settings const &settings_;
+    std::mt19937_64 gen_;
+    std::exponential_distribution<double> increment_dist_;
+    std::uniform_int_distribution<std::uint32_t> lp_dist_;
+    std::uniform_real_distribution<double> unit_dist_{0.0, 1.0};
+
+   public:
+    EventGenerator(Settings const &settings, std::uint64_t seed)
+        : settings_{settings},
+          gen_{seed},
+          increment_dist_{1.0 / settings.mean_increment},
+          lp_dist_{0, settings.num_lps - 1} {
+    }
+
+    std::uint64_t timestamp(std::uint64_t now) {
+        return now + settings_.lookahead + static_cast<std::uint64_t>(increment_dist_(gen_));
+    }
+
+    std::uint32_t target(std::uint32_t lp) {
+        return unit_dist_(gen_) < settings_.remote_probability ? lp_dist_(gen_) : lp;
+    }
+
+    std::uint32_t num_children() {
+        if (settings_.fan_out <= 1) {
+            return settings_.fan_out;
+        }
+        return unit_dist_(gen_) * settings_.fan_out < 1.0 ? settings_.fan_out : 0;
+    }
+};
+
+template <typename MultiQueue>
+Result run(Settings const &settings, unsigned int num_threads) {
+    struct alignas(2 * L1_CACHE_LINESIZE) Counters {
+        std::uint64_t events = 0;
+        std::uint64_t out_of_order = 0;
+    };
+
+    MultiQueue pq{num_threads};
+    // Timestamp of the latest event processed by each LP
+    auto lp_time = std::make_unique<std::atomic_uint64_t[]>(settings.num_lps);
+    // Events pushed but not yet processed
+    std::atomic_int64_t pending{0};
+    {
+        EventGenerator gen{settings, 0};
+        for (std::uint32_t lp = 0; lp < settings.num_lps; ++lp) {
+            lp_time[lp].store(0, std::memory_order_relaxed);
+            for (std::uint32_t i = 0; i < settings.events_per_lp; ++i) {
+                auto const t = gen.timestamp(0);
+                if (t < settings.end_time) {
+                    pq.push(pq.get_handle(lp % num_threads), {t, lp});
+                    pending.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    std::vector<Counters> counters(num_threads);
+
+    auto const begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (unsigned int id = 0; id < num_threads; ++id) {
+        threads.emplace_back([&, id]() {
+            auto handle = pq.get_handle(id);
+            auto &c = counters[id];
+            EventGenerator gen{settings, id + 1};
+            typename MultiQueue::value_type event;
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!pq.extract_top(handle, event)) {
+                    continue;
+                }
+                auto const [now, lp] = event;
+                auto latest = lp_time[lp].load(std::memory_order_relaxed);
+                while (latest < now && !lp_time[lp].compare_exchange_weak(latest, now, std::memory_order_relaxed)) {
+                }
+                if (now < latest) {
+                    ++c.out_of_order;
+                }
+                for (unsigned int i = 0; i < settings.work; ++i) {
+                    multiqueue::util::cpu_relax();
+                }
+                for (auto n = gen.num_children(); n > 0; --n) {
+                    auto const t = gen.timestamp(now);
+                    if (t < settings.end_time) {
+                        // Count before pushing, as another thread might process the event immediately
+                        pending.fetch_add(1, std::memory_order_relaxed);
+                        pq.push(handle, {t, gen.target(lp)});
+                    }
+                }
+                ++c.events;
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    Result result;
+    result.seconds = std::chrono::duration<double>(end - begin).count();
+    for (auto const &c : counters) {
+        result.events += c.events;
+        result.out_of_order += c.out_of_order;
+    }
+    return result;
+}
+
+template <typename Configuration>
+void run_all(Settings const &settings, std::ostream &out, std::string const &configuration) {
+    if (!settings.configurations.empty() &&
+        std::find(settings.configurations.begin(), settings.configurations.end(), configuration) ==
+            settings.configurations.end()) {
+        return;
+    }
+    using multiqueue_t = multiqueue::multiqueue<std::uint64_t, std::uint32_t, std::less<std::uint64_t>, Configuration>;
+    for (auto num_threads : settings.threads) {
+        for (unsigned int r = 0; r < settings.repetitions; ++r) {
+            auto const result = run<multiqueue_t>(settings, num_threads);
+            out << configuration << ',' << num_threads << ',' << r << ',' << settings.num_lps << ','
+                << settings.lookahead << ',' << settings.fan_out << ',' << result.seconds << ',' << result.events
+                << ',' << static_cast<double>(result.events) / result.seconds << ','
+                << (result.events == 0 ? 0.0
+                                       : static_cast<double>(result.out_of_order) / static_cast<double>(result.events))
+                << std::endl;
+        }
+    }
+}
+
+template <unsigned int Stickiness>
+struct Sticky : multiqueue::configuration::Default {
+    static constexpr unsigned int K = Stickiness;
+};
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    Settings settings;
+    std::ofstream file;
+    std::ostream *out = &std::cout;
+    for (int i = 1; i < argc; ++i) {
+        std::string const option = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value of option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+        std::string const value = argv[++i];
+        if (option == "-l") {
+            settings.num_lps = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (option == "-e") {
+            settings.events_per_lp = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (option == "-a") {
+            settings.lookahead = std::stoull(value);
+        } else if (option == "-m") {
+            settings.mean_increment = std::stod(value);
+        } else if (option == "-f") {
+            settings.fan_out = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (option == "-p") {
+            settings.remote_probability = std::stod(value);
+        } else if (option == "-x") {
+            settings.end_time = std::stoull(value);
+        } else if (option == "-w") {
+            settings.work = static_cast<unsigned int>(std::stoul(value));
+        } else if (option == "-t") {
+            for (auto const &t : split(value)) {
+                settings.threads.push_back(static_cast<unsigned int>(std::stoul(t)));
+            }
+        } else if (option == "-c") {
+            settings.configurations = split(value);
+        } else if (option == "-r") {
+            settings.repetitions = static_cast<unsigned int>(std::stoul(value));
+        } else if (option == "-o") {
+            file.open(value);
+            out = &file;
+        } else {
+            std::cerr << "Unknown option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.num_lps == 0) {
+        std::cerr << "At least one LP is required\n";
+        return EXIT_FAILURE;
+    }
+    if (settings.threads.empty()) {
+        for (unsigned int t = 1; t <= std::max(1u, std::thread::hardware_concurrency()); t *= 2) {
+            settings.threads.push_back(t);
+        }
+    }
+
+    namespace config = multiqueue::configuration;
+    *out << "configuration,threads,repetition,lps,lookahead,fan_out,seconds,events,events_per_second,"
+            "out_of_order_fraction\n";
+    run_all<config::Default>(settings, *out, "Default");
+    run_all<config::NoBuffering>(settings, *out, "NoBuffering");
+    run_all<config::DeleteBuffering>(settings, *out, "DeleteBuffering");
+    run_all<config::InsertBuffering>(settings, *out, "InsertBuffering");
+    run_all<config::FullBuffering>(settings, *out, "FullBuffering");
+    run_all<config::Merging>(settings, *out, "Merging");
+    run_all<config::AdaptiveStickiness>(settings, *out, "AdaptiveStickiness");
+    run_all<config::Staging>(settings, *out, "Staging");
+    run_all<Sticky<4>>(settings, *out, "K4");
+    run_all<Sticky<16>>(settings, *out, "K16");
+    return EXIT_SUCCESS;
+}
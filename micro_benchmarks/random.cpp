@@ -0,0 +1,79 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/random.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr std::size_t num_queues = 64;
+
+template <typename Engine>
+struct WithEngine : multiqueue::configuration::Default {
+    using RandomEngine = Engine;
+    static constexpr std::size_t ReservePerQueue = 1 << 12;
+};
+
+TEST_CASE("Sampling with std::uniform_int_distribution", "[benchmark][random]") {
+    std::mt19937 gen;
+    std::uniform_int_distribution<std::size_t> dist(0, num_queues - 1);
+    // Catch runs enough iterations to report the time of a single sampling step
+    BENCHMARK("sample_pair") {
+        return dist(gen) + dist(gen);
+    };
+}
+
+TEMPLATE_TEST_CASE("Sampling with index sampler", "[benchmark][random]", std::mt19937, multiqueue::util::splitmix64,
+                   multiqueue::util::wyrand, multiqueue::util::xoshiro256starstar) {
+    multiqueue::util::index_sampler<TestType> sampler;
+    std::seed_seq seq{0};
+    sampler.seed(seq);
+    sampler.set_size(num_queues);
+    BENCHMARK("sample_pair") {
+        std::size_t first;
+        std::size_t second;
+        sampler(first, second);
+        return first + second;
+    };
+}
+
+TEMPLATE_TEST_CASE("Random engines end to end", "[benchmark][random]", std::mt19937, multiqueue::util::splitmix64,
+                   multiqueue::util::wyrand, multiqueue::util::xoshiro256starstar) {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, WithEngine<TestType>>;
+    static constexpr int ops_per_thread = 100'000;
+    unsigned int const num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Each thread alternates pushes and extractions, divide by 2 * ops_per_thread for the time per operation
+    BENCHMARK("push_extract") {
+        auto pq = multiqueue_t{num_threads};
+        std::atomic_int extracted{0};
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (unsigned int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&pq, &extracted, t]() {
+                auto handle = pq.get_handle(t);
+                typename multiqueue_t::value_type retval;
+                int count = 0;
+                for (int i = 0; i < ops_per_thread; ++i) {
+                    pq.push(handle, {static_cast<int>(t) * ops_per_thread + i, i});
+                    if (pq.extract_top(handle, retval)) {
+                        ++count;
+                    }
+                }
+                extracted.fetch_add(count, std::memory_order_relaxed);
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        return extracted.load();
+    };
+}
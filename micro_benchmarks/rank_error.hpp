@@ -0,0 +1,49 @@
+#pragma once
+#ifndef MICRO_BENCHMARKS_RANK_ERROR_HPP_INCLUDED
+#define MICRO_BENCHMARKS_RANK_ERROR_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Timestamped extraction of a key
+using extraction_log = std::vector<std::pair<std::chrono::steady_clock::rep, std::uint32_t>>;
+
+inline void log_extraction(extraction_log &log, std::uint32_t key) {
+    log.emplace_back(std::chrono::steady_clock::now().time_since_epoch().count(), key);
+}
+
+// Replays the extractions of the keys [0, num_keys) in the order of their timestamps and returns the average number
+// of smaller keys that were still contained when a key was extracted
+inline double average_rank_error(std::vector<extraction_log> const &logs, std::uint32_t num_keys) {
+    extraction_log log;
+    for (auto const &l : logs) {
+        log.insert(log.end(), l.begin(), l.end());
+    }
+    std::sort(log.begin(), log.end());
+    // Fenwick tree over the contained keys
+    std::vector<std::uint32_t> tree(num_keys + 1, 0);
+    for (std::uint32_t i = 1; i <= num_keys; ++i) {
+        ++tree[i];
+        auto const parent = i + (i & (~i + 1));
+        if (parent <= num_keys) {
+            tree[parent] += tree[i];
+        }
+    }
+    double sum = 0;
+    for (auto const &[time, key] : log) {
+        std::uint64_t smaller = 0;
+        for (auto i = key; i > 0; i -= i & (~i + 1)) {
+            smaller += tree[i];
+        }
+        sum += static_cast<double>(smaller);
+        for (auto i = key + 1; i <= num_keys; i += i & (~i + 1)) {
+            --tree[i];
+        }
+    }
+    return log.empty() ? 0.0 : sum / static_cast<double>(log.size());
+}
+
+#endif  //! MICRO_BENCHMARKS_RANK_ERROR_HPP_INCLUDED
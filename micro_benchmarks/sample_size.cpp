@@ -0,0 +1,45 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+
+#include "extract_all.hpp"
+#include "rank_error.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t num_elements = 1 << 18;
+
+template <unsigned int D>
+struct WithSampleSize : multiqueue::configuration::Default {
+    static constexpr unsigned int ExtractSampleSize = D;
+    static constexpr std::size_t ReservePerQueue = 1 << 16;
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Extraction sample size", "[benchmark][sample_size]", WithSampleSize<1>, WithSampleSize<2>,
+                   WithSampleSize<3>, WithSampleSize<4>, WithSampleSize<8>) {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>;
+    unsigned int const num_threads = std::max(2u, std::thread::hardware_concurrency());
+
+    {
+        auto pq = multiqueue_t{num_threads};
+        prefill(pq, num_threads, num_elements);
+        auto const logs = extract_all_logged(pq, num_threads);
+        std::cout << "sample size " << TestType::ExtractSampleSize << ": average rank error "
+                  << average_rank_error(logs, num_elements) << '\n';
+    }
+
+    BENCHMARK_ADVANCED("extract_all")(Catch::Benchmark::Chronometer meter) {
+        measure_extract_all<multiqueue_t>(meter, num_threads, num_elements);
+    };
+}
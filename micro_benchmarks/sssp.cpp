@@ -0,0 +1,186 @@
+// Time to solution and wasted work of parallel SSSP with the int multiqueue in different configurations. The results
+// are written as CSV with one line per run.
+//
+// Usage: sssp [options]
+//   -g <graph>  Graph to run on, can be given multiple times (default: grid:1000x1000)
+//                 file:<path>          DIMACS graph if the path ends in ".gr", edge list otherwise
+//                 grid:<rows>x<cols>   Grid with random weights
+//                 geometric:<n>        Random geometric graph with about 10 neighbors per node
+//                 rmat:<scale>         R-MAT graph with 2^scale nodes and 16 edges per node
+//   -s <node>   Source node (default: 0)
+//   -t <list>   Thread counts (default: powers of two up to the hardware concurrency)
+//   -c <list>   Configurations from configurations.hpp
+//   -r <num>    Repetitions of each run (default: 1)
+//   -v          Verify the distances against sequential Dijkstra
+//   -o <file>   Output file (default: stdout)
+// Lists are comma-separated, omitted lists select everything.
+
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+
+#include "graph.hpp"
+#include "sssp.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t max_weight = 100;
+
+struct Settings {
+    std::vector<std::string> graphs;
+    std::uint32_t source = 0;
+    std::vector<unsigned int> threads;
+    std::vector<std::string> configurations;
+    unsigned int repetitions = 1;
+    bool verify = false;
+};
+
+std::vector<std::string> split(std::string const &list, char delimiter = ',') {
+    std::vector<std::string> items;
+    std::stringstream ss{list};
+    for (std::string item; std::getline(ss, item, delimiter);) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+Graph load_graph(std::string const &spec) {
+    auto const colon = spec.find(':');
+    if (colon == std::string::npos) {
+        throw std::runtime_error{"Invalid graph: " + spec};
+    }
+    auto const kind = spec.substr(0, colon);
+    auto const arg = spec.substr(colon + 1);
+    if (kind == "file") {
+        return read_graph(arg);
+    }
+    if (kind == "grid") {
+        auto const dims = split(arg, 'x');
+        if (dims.size() != 2) {
+            throw std::runtime_error{"Invalid grid: " + spec};
+        }
+        return generate_grid(static_cast<std::uint32_t>(std::stoul(dims[0])),
+                             static_cast<std::uint32_t>(std::stoul(dims[1])), max_weight);
+    }
+    if (kind == "geometric") {
+        auto const n = static_cast<std::uint32_t>(std::stoul(arg));
+        // Expected number of neighbors is n * pi * r^2
+        return generate_geometric(n, std::sqrt(10.0 / (3.14159265358979 * n)));
+    }
+    if (kind == "rmat") {
+        return generate_rmat(static_cast<unsigned int>(std::stoul(arg)), 16, max_weight);
+    }
+    throw std::runtime_error{"Unknown graph kind: " + kind};
+}
+
+template <typename Configuration>
+void run(Settings const &settings, std::ostream &out, std::string const &name, Graph const &graph,
+         std::string const &configuration, std::vector<std::uint32_t> const &reference) {
+    if (!settings.configurations.empty() &&
+        std::find(settings.configurations.begin(), settings.configurations.end(), configuration) ==
+            settings.configurations.end()) {
+        return;
+    }
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Configuration>;
+    for (auto num_threads : settings.threads) {
+        for (unsigned int r = 0; r < settings.repetitions; ++r) {
+            auto const result = parallel_sssp<multiqueue_t>(graph, settings.source, num_threads);
+            if (settings.verify && result.dist != reference) {
+                std::cerr << "Wrong distances with " << configuration << " on " << num_threads << " threads\n";
+                std::exit(EXIT_FAILURE);
+            }
+            out << name << ',' << graph.num_nodes() << ',' << graph.num_edges() << ',' << configuration << ','
+                << num_threads << ',' << r << ',' << result.seconds << ',' << result.reached() << ','
+                << result.pops << ',' << result.stale_pops << ',' << result.wasted() << ',' << result.pushes
+                << std::endl;
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    Settings settings;
+    std::ofstream file;
+    std::ostream *out = &std::cout;
+    for (int i = 1; i < argc; ++i) {
+        std::string const option = argv[i];
+        if (option == "-v") {
+            settings.verify = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Missing value of option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+        std::string const value = argv[++i];
+        if (option == "-g") {
+            settings.graphs.push_back(value);
+        } else if (option == "-s") {
+            settings.source = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (option == "-t") {
+            for (auto const &t : split(value)) {
+                settings.threads.push_back(static_cast<unsigned int>(std::stoul(t)));
+            }
+        } else if (option == "-c") {
+            settings.configurations = split(value);
+        } else if (option == "-r") {
+            settings.repetitions = static_cast<unsigned int>(std::stoul(value));
+        } else if (option == "-o") {
+            file.open(value);
+            out = &file;
+        } else {
+            std::cerr << "Unknown option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.graphs.empty()) {
+        settings.graphs.push_back("grid:1000x1000");
+    }
+    if (settings.threads.empty()) {
+        for (unsigned int t = 1; t <= std::max(1u, std::thread::hardware_concurrency()); t *= 2) {
+            settings.threads.push_back(t);
+        }
+    }
+
+    namespace config = multiqueue::configuration;
+    *out << "graph,nodes,edges,configuration,threads,repetition,seconds,reached,pops,stale_pops,wasted,pushes\n";
+    for (auto const &name : settings.graphs) {
+        Graph graph;
+        try {
+            graph = load_graph(name);
+        } catch (std::exception const &e) {
+            std::cerr << e.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        if (settings.source >= graph.num_nodes()) {
+            std::cerr << "Source " << settings.source << " is not a node of " << name << '\n';
+            return EXIT_FAILURE;
+        }
+        std::vector<std::uint32_t> reference;
+        if (settings.verify) {
+            reference = dijkstra(graph, settings.source);
+        }
+        run<config::Default>(settings, *out, name, graph, "Default", reference);
+        run<config::NoBuffering>(settings, *out, name, graph, "NoBuffering", reference);
+        run<config::Merging>(settings, *out, name, graph, "Merging", reference);
+        run<config::DeletionCache>(settings, *out, name, graph, "DeletionCache", reference);
+        run<config::Combining>(settings, *out, name, graph, "Combining", reference);
+        run<config::AdaptiveStickiness>(settings, *out, name, graph, "AdaptiveStickiness", reference);
+    }
+    return EXIT_SUCCESS;
+}
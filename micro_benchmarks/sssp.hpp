@@ -0,0 +1,155 @@
+#pragma once
+#ifndef MICRO_BENCHMARKS_SSSP_HPP_INCLUDED
+#define MICRO_BENCHMARKS_SSSP_HPP_INCLUDED
+
+#include "graph.hpp"
+
+#include "system_config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr std::uint32_t unreachable = std::numeric_limits<std::uint32_t>::max();
+
+// Lowers `dist` to `d` and returns true if `d` was smaller
+inline bool relax(std::atomic_uint32_t &dist, std::uint32_t d) {
+    auto current = dist.load(std::memory_order_relaxed);
+    while (d < current) {
+        if (dist.compare_exchange_weak(current, d, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Distances are capped below `unreachable`, which the int multiqueues reserve as sentinel key
+inline std::uint32_t add_weight(std::uint32_t dist, std::uint32_t weight) noexcept {
+    return static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t{dist} + weight, unreachable - 1));
+}
+
+// Sequential Dijkstra as reference
+inline std::vector<std::uint32_t> dijkstra(Graph const &graph, std::uint32_t source) {
+    std::vector<std::uint32_t> dist(graph.num_nodes(), unreachable);
+    using entry = std::pair<std::uint32_t, std::uint32_t>;
+    std::priority_queue<entry, std::vector<entry>, std::greater<>> pq;
+    dist[source] = 0;
+    pq.push({0, source});
+    while (!pq.empty()) {
+        auto const [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) {
+            continue;
+        }
+        for (auto e = graph.first_edge[u]; e < graph.first_edge[u + 1]; ++e) {
+            auto const nd = add_weight(d, graph.weight[e]);
+            if (nd < dist[graph.target[e]]) {
+                dist[graph.target[e]] = nd;
+                pq.push({nd, graph.target[e]});
+            }
+        }
+    }
+    return dist;
+}
+
+struct SsspResult {
+    std::vector<std::uint32_t> dist;
+    double seconds = 0.0;
+    // Successful extractions
+    std::uint64_t pops = 0;
+    // Extracted entries whose node had been reached on a shorter path in the meantime
+    std::uint64_t stale_pops = 0;
+    std::uint64_t pushes = 0;
+
+    std::uint64_t reached() const noexcept {
+        return static_cast<std::uint64_t>(
+            std::count_if(dist.begin(), dist.end(), [](auto d) { return d != unreachable; }));
+    }
+
+    // Nodes that were settled more than once, as their distance was improved after they had been processed
+    std::uint64_t wasted() const noexcept {
+        return pops - stale_pops - reached();
+    }
+};
+
+// Label-correcting SSSP on a relaxed priority queue. An entry is pushed whenever the distance of a node is lowered,
+// and entries that are outdated when extracted are skipped. The computation terminates once all handles failed to
+// extract and all queues are empty, as detected by `try_terminate`.
+template <typename MultiQueue>
+SsspResult parallel_sssp(Graph const &graph, std::uint32_t source, unsigned int num_threads) {
+    struct alignas(2 * L1_CACHE_LINESIZE) Counters {
+        std::uint64_t pops = 0;
+        std::uint64_t stale_pops = 0;
+        std::uint64_t pushes = 0;
+    };
+
+    auto const num_nodes = graph.num_nodes();
+    auto dist = std::make_unique<std::atomic_uint32_t[]>(num_nodes);
+    for (std::uint32_t u = 0; u < num_nodes; ++u) {
+        dist[u].store(unreachable, std::memory_order_relaxed);
+    }
+    std::vector<Counters> counters(num_threads);
+    MultiQueue pq{num_threads};
+
+    auto const begin = std::chrono::steady_clock::now();
+    dist[source].store(0, std::memory_order_relaxed);
+    pq.push(pq.get_handle(0), {0, source});
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto handle = pq.get_handle(t);
+            auto &c = counters[t];
+            typename MultiQueue::value_type top;
+            while (true) {
+                if (!pq.extract_top(handle, top)) {
+                    if (pq.try_terminate(handle)) {
+                        break;
+                    }
+                    continue;
+                }
+                ++c.pops;
+                auto const [d, u] = top;
+                if (d > dist[u].load(std::memory_order_relaxed)) {
+                    ++c.stale_pops;
+                    continue;
+                }
+                for (auto e = graph.first_edge[u]; e < graph.first_edge[u + 1]; ++e) {
+                    auto const v = graph.target[e];
+                    auto const nd = add_weight(d, graph.weight[e]);
+                    if (relax(dist[v], nd)) {
+                        ++c.pushes;
+                        pq.push(handle, {nd, v});
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    SsspResult result;
+    result.seconds = std::chrono::duration<double>(end - begin).count();
+    result.dist.resize(num_nodes);
+    for (std::uint32_t u = 0; u < num_nodes; ++u) {
+        result.dist[u] = dist[u].load(std::memory_order_relaxed);
+    }
+    for (auto const &c : counters) {
+        result.pops += c.pops;
+        result.stale_pops += c.stale_pops;
+        result.pushes += c.pushes;
+    }
+    return result;
+}
+
+#endif  //! MICRO_BENCHMARKS_SSSP_HPP_INCLUDED
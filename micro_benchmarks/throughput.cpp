@@ -0,0 +1,350 @@
+// Throughput of the multiqueue frontends under standard workloads, sweeping thread counts and key distributions. The
+// results are written as CSV with one line per run, so that configurations can be compared by scripts. Only pushes and
+// successful extractions count as operations, failed extractions are reported in a separate column. The time to
+// construct the multiqueue is reported separately as startup time.
+//
+// Usage: throughput [options]
+//   -t <list>  Thread counts (default: powers of two up to the hardware concurrency)
+//   -n <num>   Operations per thread (default: 1048576)
+//   -p <num>   Elements prefilled per thread before timing (default: 65536)
+//   -r <num>   Repetitions of each run (default: 1)
+//   -f <list>  Frontends: multiqueue, int_multiqueue, int_multiqueue_assigned
+//   -c <list>  Configurations from configurations.hpp, Numa denotes Default with numa friendliness and a reservation
+//              of 2^16 elements per queue
+//   -w <list>  Workloads: alternating, mixed, drain, hold
+//   -k <list>  Key distributions: uniform, ascending, descending, dijkstra
+//   -o <file>  Output file (default: stdout)
+// Lists are comma-separated, omitted lists select everything.
+
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/int_multiqueue_assigned.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The int multiqueues use the largest key as sentinel
+constexpr std::uint32_t max_key = std::numeric_limits<std::uint32_t>::max() - 1;
+// Consecutive failed extractions after which a drain considers the queue empty
+constexpr unsigned int drain_misses = 1000;
+// Keys pushed in the hold model exceed the extracted key by less than this
+constexpr std::uint32_t hold_increment = 1024;
+
+struct Settings {
+    std::vector<unsigned int> threads;
+    std::uint64_t operations = 1 << 20;
+    std::uint64_t prefill = 1 << 16;
+    unsigned int repetitions = 1;
+    std::vector<std::string> frontends;
+    std::vector<std::string> configurations;
+    std::vector<std::string> workloads;
+    std::vector<std::string> keys;
+};
+
+bool selected(std::vector<std::string> const &list, std::string const &name) {
+    return list.empty() || std::find(list.begin(), list.end(), name) != list.end();
+}
+
+std::vector<std::string> split(std::string const &list) {
+    std::vector<std::string> items;
+    std::stringstream ss{list};
+    for (std::string item; std::getline(ss, item, ',');) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Keys pushed by one thread. Ascending and descending keys interleave the threads, Dijkstra-like keys exceed the last
+// extracted key by a small random amount.
+class KeyGenerator {
+    enum class Distribution { uniform, ascending, descending, dijkstra };
+
+    // Resolved once, so that generating a key inside the timed loop does not compare strings
+    Distribution distribution_;
+    std::mt19937_64 gen_;
+    std::uniform_int_distribution<std::uint32_t> uniform_dist_{0, max_key};
+    std::uniform_int_distribution<std::uint32_t> dijkstra_dist_{0, 100};
+    std::uniform_int_distribution<std::uint32_t> increment_dist_{0, hold_increment - 1};
+    std::uint64_t next_;
+    std::uint64_t stride_;
+
+    static Distribution parse(std::string const &distribution) {
+        if (distribution == "ascending") {
+            return Distribution::ascending;
+        }
+        if (distribution == "descending") {
+            return Distribution::descending;
+        }
+        if (distribution == "dijkstra") {
+            return Distribution::dijkstra;
+        }
+        return Distribution::uniform;
+    }
+
+   public:
+    KeyGenerator(std::string const &distribution, unsigned int id, unsigned int num_threads)
+        : distribution_{parse(distribution)}, gen_{id}, next_{id}, stride_{num_threads} {
+    }
+
+    std::uint32_t operator()(std::uint32_t last_extracted) {
+        switch (distribution_) {
+            case Distribution::uniform:
+                return uniform_dist_(gen_);
+            case Distribution::dijkstra:
+                return static_cast<std::uint32_t>(
+                    std::min<std::uint64_t>(std::uint64_t{last_extracted} + dijkstra_dist_(gen_), max_key));
+            case Distribution::ascending:
+            case Distribution::descending:
+                break;
+        }
+        auto const key = static_cast<std::uint32_t>(std::min<std::uint64_t>(next_, max_key));
+        next_ += stride_;
+        return distribution_ == Distribution::ascending ? key : max_key - key;
+    }
+
+    std::uint32_t increment() {
+        return increment_dist_(gen_);
+    }
+
+    bool coin() {
+        return (gen_() & 1) == 1;
+    }
+};
+
+struct Result {
+    std::uint64_t operations = 0;
+    std::uint64_t failed_extractions = 0;
+    double seconds = 0.0;
+    double startup_seconds = 0.0;
+};
+
+// Prefills the queue and runs the workload on all threads, timing the construction and the workload
+template <typename MultiQueue>
+Result run(Settings const &settings, std::string const &workload, std::string const &keys, unsigned int num_threads) {
+    auto const construction = std::chrono::steady_clock::now();
+    MultiQueue pq{num_threads};
+    auto const startup_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - construction).count();
+    std::uint64_t const prefill = workload == "drain" ? settings.operations : settings.prefill;
+    bool const hold = workload == "hold";
+    std::atomic_uint ready{0};
+    std::atomic_bool start{false};
+    std::vector<std::uint64_t> operations(num_threads, 0);
+    std::vector<std::uint64_t> failed_extractions(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto handle = pq.get_handle(t);
+            KeyGenerator gen{keys, t, num_threads};
+            typename MultiQueue::value_type retval{0, 0};
+            std::uint32_t last = 0;
+            for (std::uint64_t i = 0; i < prefill; ++i) {
+                auto const key = hold ? gen.increment() : gen(0);
+                pq.push(handle, {key, key});
+            }
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            std::uint64_t count = 0;
+            std::uint64_t failed = 0;
+            if (workload == "alternating") {
+                for (std::uint64_t i = 0; i < settings.operations; ++i) {
+                    auto const key = gen(last);
+                    pq.push(handle, {key, key});
+                    if (pq.extract_top(handle, retval)) {
+                        last = retval.first;
+                    } else {
+                        ++failed;
+                    }
+                }
+                count = 2 * settings.operations - failed;
+            } else if (workload == "mixed") {
+                for (std::uint64_t i = 0; i < settings.operations; ++i) {
+                    if (gen.coin()) {
+                        auto const key = gen(last);
+                        pq.push(handle, {key, key});
+                    } else if (pq.extract_top(handle, retval)) {
+                        last = retval.first;
+                    } else {
+                        ++failed;
+                    }
+                }
+                count = settings.operations - failed;
+            } else if (workload == "drain") {
+                for (unsigned int misses = 0; misses < drain_misses;) {
+                    if (pq.extract_top(handle, retval)) {
+                        ++count;
+                        misses = 0;
+                    } else {
+                        ++failed;
+                        ++misses;
+                    }
+                }
+            } else {
+                for (std::uint64_t i = 0; i < settings.operations; ++i) {
+                    if (pq.extract_top(handle, retval)) {
+                        last = retval.first;
+                    } else {
+                        ++failed;
+                    }
+                    auto const key = static_cast<std::uint32_t>(
+                        std::min<std::uint64_t>(std::uint64_t{last} + gen.increment(), max_key));
+                    pq.push(handle, {key, key});
+                }
+                count = 2 * settings.operations - failed;
+            }
+            operations[t] = count;
+            failed_extractions[t] = failed;
+        });
+    }
+    while (ready.load(std::memory_order_acquire) != num_threads) {
+        std::this_thread::yield();
+    }
+    auto const begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto const end = std::chrono::steady_clock::now();
+    Result result;
+    for (auto c : operations) {
+        result.operations += c;
+    }
+    for (auto f : failed_extractions) {
+        result.failed_extractions += f;
+    }
+    result.seconds = std::chrono::duration<double>(end - begin).count();
+    result.startup_seconds = startup_seconds;
+    return result;
+}
+
+template <typename MultiQueue>
+void run_all(Settings const &settings, std::ostream &out, std::string const &frontend,
+             std::string const &configuration) {
+    if (!selected(settings.frontends, frontend) || !selected(settings.configurations, configuration)) {
+        return;
+    }
+    for (std::string const workload : {"alternating", "mixed", "drain", "hold"}) {
+        if (!selected(settings.workloads, workload)) {
+            continue;
+        }
+        for (std::string const keys : {"uniform", "ascending", "descending", "dijkstra"}) {
+            // The hold model determines its keys itself
+            if (!selected(settings.keys, keys) || (workload == "hold" && keys != "uniform")) {
+                continue;
+            }
+            for (auto num_threads : settings.threads) {
+                for (unsigned int r = 0; r < settings.repetitions; ++r) {
+                    auto const result = run<MultiQueue>(settings, workload, keys, num_threads);
+                    out << frontend << ',' << configuration << ',' << workload << ','
+                        << (workload == "hold" ? "increment" : keys) << ',' << num_threads << ',' << r << ','
+                        << result.operations << ',' << result.failed_extractions << ',' << result.seconds << ','
+                        << static_cast<double>(result.operations) / result.seconds / 1e6 << ','
+                        << result.startup_seconds << std::endl;
+                }
+            }
+        }
+    }
+}
+
+template <typename Configuration>
+using generic_multiqueue =
+    multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, Configuration>;
+
+template <typename Configuration>
+using int_multiqueue = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Configuration>;
+
+template <typename Configuration>
+using int_multiqueue_assigned = multiqueue::int_multiqueue_assigned<std::uint32_t, std::uint32_t, Configuration>;
+
+struct Numa : multiqueue::configuration::Default {
+    static constexpr bool NumaFriendly = true;
+    static constexpr std::size_t ReservePerQueue = 1 << 16;
+};
+
+// Runs all configurations that are supported by all frontends
+template <template <typename> class MultiQueue>
+void run_common(Settings const &settings, std::ostream &out, std::string const &frontend) {
+    namespace config = multiqueue::configuration;
+    run_all<MultiQueue<config::Default>>(settings, out, frontend, "Default");
+    run_all<MultiQueue<config::NoBuffering>>(settings, out, frontend, "NoBuffering");
+    run_all<MultiQueue<config::Merging>>(settings, out, frontend, "Merging");
+    run_all<MultiQueue<Numa>>(settings, out, frontend, "Numa");
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    Settings settings;
+    std::ofstream file;
+    std::ostream *out = &std::cout;
+    for (int i = 1; i < argc; ++i) {
+        std::string const option = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value of option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+        std::string const value = argv[++i];
+        if (option == "-t") {
+            for (auto const &t : split(value)) {
+                settings.threads.push_back(static_cast<unsigned int>(std::stoul(t)));
+            }
+        } else if (option == "-n") {
+            settings.operations = std::stoull(value);
+        } else if (option == "-p") {
+            settings.prefill = std::stoull(value);
+        } else if (option == "-r") {
+            settings.repetitions = static_cast<unsigned int>(std::stoul(value));
+        } else if (option == "-f") {
+            settings.frontends = split(value);
+        } else if (option == "-c") {
+            settings.configurations = split(value);
+        } else if (option == "-w") {
+            settings.workloads = split(value);
+        } else if (option == "-k") {
+            settings.keys = split(value);
+        } else if (option == "-o") {
+            file.open(value);
+            out = &file;
+        } else {
+            std::cerr << "Unknown option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.threads.empty()) {
+        for (unsigned int t = 1; t <= std::max(1u, std::thread::hardware_concurrency()); t *= 2) {
+            settings.threads.push_back(t);
+        }
+    }
+
+    namespace config = multiqueue::configuration;
+    *out << "frontend,configuration,workload,keys,threads,repetition,operations,failed_extractions,seconds,mops,"
+            "startup_seconds\n";
+    run_common<generic_multiqueue>(settings, *out, "multiqueue");
+    run_all<generic_multiqueue<config::Staging>>(settings, *out, "multiqueue", "Staging");
+    run_common<int_multiqueue>(settings, *out, "int_multiqueue");
+    run_all<int_multiqueue<config::DeletionCache>>(settings, *out, "int_multiqueue", "DeletionCache");
+    run_all<int_multiqueue<config::Combining>>(settings, *out, "int_multiqueue", "Combining");
+    run_all<int_multiqueue<config::AdaptiveStickiness>>(settings, *out, "int_multiqueue", "AdaptiveStickiness");
+    run_common<int_multiqueue_assigned>(settings, *out, "int_multiqueue_assigned");
+    return EXIT_SUCCESS;
+}
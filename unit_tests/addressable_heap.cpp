@@ -0,0 +1,78 @@
+#include "multiqueue/sequential/heap/addressable_heap.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using heap_t = multiqueue::sequential::addressable_heap<int, int, std::less<int>, 4>;
+
+TEST_CASE("addressable_heap random operations", "[addressable_heap]") {
+    static constexpr int num_nodes = 1000;
+    std::vector<typename heap_t::node_type> nodes(num_nodes);
+    // Reference holds (key, node index) of all contained nodes
+    std::set<std::pair<int, int>> reference;
+    heap_t heap;
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<int> node_dist(0, num_nodes - 1);
+    std::uniform_int_distribution<int> key_dist(0, 10'000);
+
+    for (int i = 0; i < 100'000; ++i) {
+        auto const n = node_dist(gen);
+        auto &node = nodes[static_cast<std::size_t>(n)];
+        auto const key = key_dist(gen);
+        switch (gen() % 5) {
+            case 0:
+            case 1:
+                if (!heap_t::contains(node)) {
+                    heap.push(node, key, n);
+                    reference.emplace(key, n);
+                }
+                break;
+            case 2:
+                if (heap_t::contains(node)) {
+                    auto const old_key = node.key();
+                    if (heap.decrease_key(node, key)) {
+                        REQUIRE(key < old_key);
+                        reference.erase({old_key, n});
+                        reference.emplace(key, n);
+                    } else {
+                        REQUIRE(key >= old_key);
+                    }
+                }
+                break;
+            case 3:
+                if (heap_t::contains(node)) {
+                    reference.erase({node.key(), n});
+                    heap.change_key(node, key);
+                    reference.emplace(key, n);
+                } else if (heap_t::contains(nodes[0])) {
+                    reference.erase({nodes[0].key(), 0});
+                    heap.erase(nodes[0]);
+                    REQUIRE_FALSE(heap_t::contains(nodes[0]));
+                }
+                break;
+            default:
+                if (!heap.empty()) {
+                    REQUIRE(heap.top().key() == reference.begin()->first);
+                    typename heap_t::value_type top;
+                    heap.extract_top(top);
+                    REQUIRE(top.first == reference.begin()->first);
+                    REQUIRE_FALSE(heap_t::contains(nodes[static_cast<std::size_t>(top.second)]));
+                    reference.erase({top.first, top.second});
+                }
+        }
+        REQUIRE(heap.size() == reference.size());
+    }
+    while (!heap.empty()) {
+        typename heap_t::value_type top;
+        heap.extract_top(top);
+        REQUIRE(top.first == reference.begin()->first);
+        reference.erase(reference.begin());
+    }
+    REQUIRE(reference.empty());
+}
@@ -0,0 +1,198 @@
+#include "multiqueue/addressable_multiqueue.hpp"
+#include "multiqueue/configurations.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// With two queues, both are compared on every successful extraction, so it returns the smallest element
+struct TwoQueues : multiqueue::configuration::Default {
+    static constexpr unsigned int C = 2;
+};
+
+using sequential_multiqueue_t = multiqueue::addressable_multiqueue<int, int, std::less<int>, TwoQueues>;
+
+// Sampling the same empty queue twice fails, so extraction is retried
+bool extract(sequential_multiqueue_t &pq, typename sequential_multiqueue_t::value_type &top) {
+    auto handle = pq.get_handle(0);
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        if (pq.extract_top(handle, top)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST_CASE("decrease_key changes the extraction order", "[addressable_multiqueue]") {
+    static constexpr int num_locators = 10;
+    auto pq = sequential_multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    std::vector<typename sequential_multiqueue_t::locator> locators(num_locators);
+    for (int l = 0; l < num_locators; ++l) {
+        pq.push(handle, locators[static_cast<std::size_t>(l)], 10 * (l + 1), l);
+    }
+    REQUIRE(pq.decrease_key(handle, locators[7], 5));
+    REQUIRE(pq.decrease_key(handle, locators[3], 25));
+    REQUIRE(locators[7].key() == 5);
+
+    // Larger or equal keys are rejected
+    REQUIRE_FALSE(pq.decrease_key(handle, locators[1], 50));
+    REQUIRE_FALSE(pq.decrease_key(handle, locators[1], 20));
+    REQUIRE(locators[1].key() == 20);
+
+    std::vector<std::pair<int, int>> expected = {{5, 7},  {10, 0}, {20, 1}, {25, 3}, {30, 2},
+                                                 {50, 4}, {60, 5}, {70, 6}, {90, 8}, {100, 9}};
+    typename sequential_multiqueue_t::value_type top;
+    for (auto const &e : expected) {
+        REQUIRE(extract(pq, top));
+        REQUIRE(top == e);
+        REQUIRE_FALSE(locators[static_cast<std::size_t>(top.second)].contained());
+    }
+    REQUIRE_FALSE(extract(pq, top));
+}
+
+TEST_CASE("erase removes only contained locators", "[addressable_multiqueue]") {
+    auto pq = sequential_multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    std::vector<typename sequential_multiqueue_t::locator> locators(3);
+    REQUIRE_FALSE(pq.erase(handle, locators[0]));
+    REQUIRE_FALSE(pq.decrease_key(handle, locators[0], 0));
+    REQUIRE_FALSE(locators[0].contained());
+    for (int l = 0; l < 3; ++l) {
+        pq.push(handle, locators[static_cast<std::size_t>(l)], l, l);
+        REQUIRE(locators[static_cast<std::size_t>(l)].contained());
+    }
+    REQUIRE(pq.erase(handle, locators[1]));
+    REQUIRE_FALSE(locators[1].contained());
+    REQUIRE_FALSE(pq.erase(handle, locators[1]));
+    typename sequential_multiqueue_t::value_type top;
+    REQUIRE(extract(pq, top));
+    REQUIRE(top.second == 0);
+    REQUIRE_FALSE(pq.erase(handle, locators[0]));
+    REQUIRE(extract(pq, top));
+    REQUIRE(top.second == 2);
+    REQUIRE_FALSE(extract(pq, top));
+    // Erased locators can be pushed again
+    pq.push(handle, locators[1], 1, 1);
+    REQUIRE(extract(pq, top));
+    REQUIRE(top.second == 1);
+}
+
+TEST_CASE("push_or_decrease_key keeps the smallest key", "[addressable_multiqueue][workloads]") {
+    using multiqueue_t = multiqueue::addressable_multiqueue<int, int>;
+    static constexpr unsigned int num_threads = 4;
+    static constexpr int num_locators = 1000;
+    static constexpr int updates_per_thread = 20'000;
+    auto pq = multiqueue_t{num_threads};
+    std::vector<typename multiqueue_t::locator> locators(num_locators);
+    // The smallest key any thread offered for each locator
+    std::vector<std::atomic_int> min_key(num_locators);
+    for (auto &k : min_key) {
+        k.store(updates_per_thread * static_cast<int>(num_threads) + 1);
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto handle = pq.get_handle(t);
+            std::mt19937 gen{t};
+            std::uniform_int_distribution<int> locator_dist(0, num_locators - 1);
+            std::uniform_int_distribution<int> key_dist(0, updates_per_thread * static_cast<int>(num_threads));
+            for (int i = 0; i < updates_per_thread; ++i) {
+                auto const l = locator_dist(gen);
+                auto const key = key_dist(gen);
+                auto current = min_key[static_cast<std::size_t>(l)].load();
+                while (key < current && !min_key[static_cast<std::size_t>(l)].compare_exchange_weak(current, key)) {
+                }
+                pq.push_or_decrease_key(handle, locators[static_cast<std::size_t>(l)], key, l);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto handle = pq.get_handle(0);
+    typename multiqueue_t::value_type top;
+    int count = 0;
+    while (count < num_locators && pq.extract_top(handle, top)) {
+        ++count;
+    }
+    // Sampling can miss the remaining nonempty queues, so drain by erasing
+    for (int l = 0; l < num_locators; ++l) {
+        if (locators[static_cast<std::size_t>(l)].contained()) {
+            REQUIRE(locators[static_cast<std::size_t>(l)].key() == min_key[static_cast<std::size_t>(l)].load());
+            REQUIRE(pq.erase(handle, locators[static_cast<std::size_t>(l)]));
+            ++count;
+        }
+    }
+    REQUIRE(count == num_locators);
+    for (auto const &loc : locators) {
+        REQUIRE_FALSE(loc.contained());
+    }
+}
+
+TEST_CASE("push_or_decrease_key concurrent with extractions", "[addressable_multiqueue][workloads]") {
+    using multiqueue_t = multiqueue::addressable_multiqueue<int, int>;
+    static constexpr unsigned int num_pushers = 2;
+    static constexpr unsigned int num_extractors = 2;
+    static constexpr int num_locators = 100;
+    static constexpr int updates_per_thread = 20'000;
+    auto pq = multiqueue_t{num_pushers + num_extractors};
+    std::vector<typename multiqueue_t::locator> locators(num_locators);
+    std::vector<std::atomic_int> pushes(num_locators);
+    std::vector<std::atomic_int> extractions(num_locators);
+    std::atomic_uint pushers_done{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_pushers; ++t) {
+        threads.emplace_back([&, t]() {
+            auto handle = pq.get_handle(t);
+            std::mt19937 gen{t};
+            std::uniform_int_distribution<int> locator_dist(0, num_locators - 1);
+            std::uniform_int_distribution<int> key_dist(0, 1'000'000);
+            for (int i = 0; i < updates_per_thread; ++i) {
+                auto const l = static_cast<std::size_t>(locator_dist(gen));
+                if (pq.push_or_decrease_key(handle, locators[l], key_dist(gen), static_cast<int>(l))) {
+                    pushes[l].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            pushers_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+    for (unsigned int t = num_pushers; t < num_pushers + num_extractors; ++t) {
+        threads.emplace_back([&, t]() {
+            auto handle = pq.get_handle(t);
+            typename multiqueue_t::value_type top;
+            // Misses only count once the pushers are done, then the queue is drained until it appears empty
+            for (unsigned int misses = 0; misses < 1000;) {
+                bool const pushing = pushers_done.load(std::memory_order_acquire) < num_pushers;
+                if (pq.extract_top(handle, top)) {
+                    extractions[static_cast<std::size_t>(top.second)].fetch_add(1, std::memory_order_relaxed);
+                    misses = 0;
+                } else if (!pushing) {
+                    ++misses;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t l = 0; l < num_locators; ++l) {
+        REQUIRE_FALSE(locators[l].contained());
+        REQUIRE(pushes[l].load() > 0);
+        REQUIRE(extractions[l].load() == pushes[l].load());
+    }
+}
@@ -0,0 +1,93 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue_assigned.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct composite_key {
+    std::uint32_t major;
+    std::uint32_t minor;
+};
+
+// Orders by `major` descending, then by `minor` ascending
+struct composite_compare {
+    bool operator()(composite_key const &lhs, composite_key const &rhs) const noexcept {
+        return std::tie(rhs.major, lhs.minor) < std::tie(lhs.major, rhs.minor);
+    }
+};
+
+struct Leases : multiqueue::configuration::Default {
+    static constexpr unsigned int K = 8;
+    static constexpr std::size_t ReservePerQueue = 1 << 10;
+};
+
+struct LeasesMerging : Leases {
+    static constexpr bool UseMergeHeap = true;
+};
+
+struct SingleOperationLeases : Leases {
+    static constexpr unsigned int K = 1;
+    static constexpr bool WithDeletionBuffer = false;
+    static constexpr bool WithInsertionBuffer = false;
+};
+
+}  // namespace
+
+TEST_CASE("assigned multiqueue orders composite keys", "[assigned]") {
+    using multiqueue_t = multiqueue::multiqueue_assigned<composite_key, std::uint32_t, composite_compare, Leases>;
+    auto pq = multiqueue_t{1, composite_compare{}};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        pq.push(handle, {{i % 10, i}, i});
+    }
+    pq.flush(handle);
+    typename multiqueue_t::value_type top;
+    std::vector<std::uint32_t> extracted;
+    for (unsigned int misses = 0; misses < 1000;) {
+        if (pq.extract_top(handle, top)) {
+            extracted.push_back(top.second);
+            misses = 0;
+        } else {
+            ++misses;
+        }
+    }
+    std::sort(extracted.begin(), extracted.end());
+    REQUIRE(extracted.size() == 100);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        REQUIRE(extracted[i] == i);
+    }
+}
+
+TEST_CASE("assigned multiqueue extracts in order from owned queues", "[assigned]") {
+    using multiqueue_t = multiqueue::multiqueue_assigned<composite_key, std::uint32_t, composite_compare, Leases>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    // All elements end up in a single queue, as the lease covers all pushes
+    for (std::uint32_t i = 0; i < Leases::K; ++i) {
+        pq.push(handle, {{i, 0}, i});
+    }
+    typename multiqueue_t::value_type top;
+    // Retry until the queue with the elements is owned for extraction
+    while (!pq.extract_top(handle, top)) {
+    }
+    REQUIRE(top.second == Leases::K - 1);
+    for (std::uint32_t i = Leases::K - 1; i > 0; --i) {
+        REQUIRE(pq.extract_top(handle, top));
+        REQUIRE(top.second == i - 1);
+    }
+}
+
+TEMPLATE_TEST_CASE("assigned multiqueue keeps all elements", "[assigned][workloads]", Leases, LeasesMerging,
+                   SingleOperationLeases) {
+    auto pq = multiqueue::multiqueue_assigned<std::uint32_t, std::uint32_t, std::less<>, TestType>{4};
+    workloads::require_all_extracted(workloads::push_extract_drain(pq, 4, 20'000, workloads::flush{}), 4 * 20'000);
+}
@@ -0,0 +1,150 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>   // std::shuffle, std::is_sorted
+#include <cstdint>
+#include <functional>  // std::less
+#include <iterator>    // std::back_inserter
+#include <numeric>     // std::iota
+#include <random>
+#include <vector>
+
+namespace {
+
+// Larger than the node size of the merge heap, so that full nodes are inserted directly
+constexpr std::uint32_t batch_size = 1000;
+static_assert(batch_size > 4 * multiqueue::configuration::Merging::NodeSize);
+
+template <typename Configuration>
+using generic_multiqueue =
+    multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, Configuration>;
+
+template <typename Configuration>
+using int_multiqueue = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Configuration>;
+
+namespace config = multiqueue::configuration;
+
+// All elements are in one queue, so every extraction locks it
+template <typename Configuration>
+struct SingleQueue : Configuration {
+    static constexpr unsigned int C = 1;
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("push_batch single thread", "[batch][workloads]", generic_multiqueue<config::NoBuffering>,
+                   generic_multiqueue<config::DeleteBuffering>, generic_multiqueue<config::InsertBuffering>,
+                   generic_multiqueue<config::FullBuffering>, generic_multiqueue<config::Merging>,
+                   int_multiqueue<config::NoBuffering>, int_multiqueue<config::FullBuffering>,
+                   int_multiqueue<config::Merging>) {
+    using multiqueue_t = TestType;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+
+    std::vector<typename multiqueue_t::value_type> batch(batch_size);
+    for (std::uint32_t i = 0; i < batch_size; ++i) {
+        batch[i] = {i, batch_size - i - 1};
+    }
+    std::shuffle(batch.begin(), batch.end(), std::mt19937{0});
+
+    SECTION("one batch ends up sorted in one queue") {
+        pq.push_batch(handle, batch.begin(), batch.end());
+        std::vector<std::uint32_t> v;
+        typename multiqueue_t::value_type top;
+        while (pq.extract_from_partition(handle, top)) {
+            REQUIRE(top.first == batch_size - top.second - 1);
+            v.push_back(top.first);
+        }
+        REQUIRE(v.size() == batch_size);
+        REQUIRE(std::is_sorted(v.begin(), v.end()));
+        REQUIRE(v.front() == 0);
+        REQUIRE(v.back() == batch_size - 1);
+    }
+
+    SECTION("batches interleaved with single pushes") {
+        auto middle = batch.begin() + batch_size / 2;
+        pq.push_batch(handle, batch.begin(), middle);
+        for (auto it = middle; it != batch.end(); ++it) {
+            pq.push(handle, *it);
+        }
+        pq.push_batch(handle, batch.end(), batch.end());
+        std::vector<std::uint32_t> v;
+        typename multiqueue_t::value_type top;
+        while (pq.extract_from_partition(handle, top)) {
+            v.push_back(top.first);
+        }
+        REQUIRE(v.size() == batch_size);
+        std::sort(v.begin(), v.end());
+        std::vector<std::uint32_t> expected(batch_size);
+        std::iota(expected.begin(), expected.end(), 0u);
+        REQUIRE(v == expected);
+    }
+}
+
+TEMPLATE_TEST_CASE("extract_batch single thread", "[batch][workloads]", generic_multiqueue<config::NoBuffering>,
+                   generic_multiqueue<config::DeleteBuffering>, generic_multiqueue<config::FullBuffering>,
+                   generic_multiqueue<config::Merging>, int_multiqueue<config::NoBuffering>,
+                   int_multiqueue<config::FullBuffering>, int_multiqueue<config::Merging>) {
+    using multiqueue_t = TestType;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+
+    std::vector<typename multiqueue_t::value_type> batch(batch_size);
+    for (std::uint32_t i = 0; i < batch_size; ++i) {
+        batch[i] = {i, batch_size - i - 1};
+    }
+    std::shuffle(batch.begin(), batch.end(), std::mt19937{0});
+    pq.push_batch(handle, batch.begin(), batch.end());
+
+    std::vector<typename multiqueue_t::value_type> v;
+    // All elements are in the same queue, so sampling only succeeds eventually
+    for (std::uint32_t attempt = 0; attempt < 100 * batch_size && v.size() < batch_size; ++attempt) {
+        auto const old_size = v.size();
+        auto const count = pq.extract_batch(handle, std::back_inserter(v), 64);
+        REQUIRE(count <= 64);
+        REQUIRE(v.size() == old_size + count);
+        REQUIRE(std::is_sorted(v.begin() + static_cast<std::ptrdiff_t>(old_size), v.end()));
+    }
+    REQUIRE(v.size() == batch_size);
+    for (auto const &[key, value] : v) {
+        REQUIRE(key == batch_size - value - 1);
+    }
+    REQUIRE(std::is_sorted(v.begin(), v.end()));
+    REQUIRE(pq.extract_batch(handle, std::back_inserter(v), 64) == 0);
+}
+
+TEMPLATE_TEST_CASE("extract_batch publishes the top key after a partial drain", "[batch]",
+                   SingleQueue<config::NoBuffering>, SingleQueue<config::FullBuffering>,
+                   SingleQueue<config::Merging>) {
+    using multiqueue_t = int_multiqueue<TestType>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+
+    std::vector<typename multiqueue_t::value_type> batch(batch_size);
+    for (std::uint32_t i = 0; i < batch_size; ++i) {
+        batch[i] = {i, batch_size - i - 1};
+    }
+    std::shuffle(batch.begin(), batch.end(), std::mt19937{0});
+    pq.push_batch(handle, batch.begin(), batch.end());
+
+    std::vector<typename multiqueue_t::value_type> v;
+    REQUIRE(pq.extract_batch(handle, std::back_inserter(v), 100) == 100);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        REQUIRE(v[i].first == i);
+    }
+    // A stale top key would let the queue appear empty
+    typename multiqueue_t::value_type top;
+    REQUIRE(pq.extract_top(handle, top));
+    REQUIRE(top.first == 100);
+    v.clear();
+    REQUIRE(pq.extract_batch(handle, std::back_inserter(v), batch_size) == batch_size - 101);
+    REQUIRE(v.front().first == 101);
+    REQUIRE(std::is_sorted(v.begin(), v.end()));
+    REQUIRE_FALSE(pq.extract_top(handle, top));
+    pq.push(handle, {0, 0});
+    REQUIRE(pq.extract_batch(handle, std::back_inserter(v), batch_size) == 1);
+}
@@ -0,0 +1,128 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/util/combining.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <cstdint>
+#include <utility>
+
+namespace multiqueue {
+
+template <typename Key, typename T, typename Configuration, typename Allocator>
+struct test_access<int_multiqueue<Key, T, Configuration, Allocator>> {
+    using multiqueue_t = int_multiqueue<Key, T, Configuration, Allocator>;
+
+    static bool try_lock(multiqueue_t &pq, typename multiqueue_t::Handle handle, std::size_t index) {
+        return pq.try_lock_queue(handle, index, true);
+    }
+
+    static void unlock(multiqueue_t &pq, typename multiqueue_t::Handle handle, std::size_t index) {
+        pq.unlock_queue(handle, index);
+    }
+
+    static auto &publications(multiqueue_t &pq, std::size_t index) {
+        return pq.publications_[index];
+    }
+};
+
+}  // namespace multiqueue
+
+struct CombiningMerging : multiqueue::configuration::Combining {
+    static constexpr bool UseMergeHeap = true;
+};
+
+struct CombiningSingleQueue : multiqueue::configuration::Combining {
+    // All threads contend on few queues, so operations get delegated
+    static constexpr unsigned int C = 1;
+    static constexpr std::size_t CombiningSlots = 2;
+};
+
+TEMPLATE_TEST_CASE("int_multiqueue combining keeps all elements", "[combining][workloads]",
+                   multiqueue::configuration::Combining, CombiningMerging, CombiningSingleQueue) {
+    auto pq = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>{4};
+    workloads::require_all_extracted(workloads::push_extract_drain(pq, 4, 20'000), 4 * 20'000);
+}
+
+TEST_CASE("publication_list serves every pending request once", "[combining]") {
+    using list_t = multiqueue::util::publication_list<int, 2>;
+    using request = list_t::request;
+    list_t list;
+    auto const push_slot = list.post(request::push, 0, 1);
+    auto const extract_slot = list.post(request::extract, 1, 0);
+    REQUIRE(push_slot != list_t::npos);
+    REQUIRE(extract_slot != list_t::npos);
+    REQUIRE(list.post(request::push, 2, 2) == list_t::npos);
+    int served = 0;
+    auto apply = [&served](request kind, std::uint32_t /*id*/, int &value) {
+        ++served;
+        if (kind == request::extract) {
+            return false;
+        }
+        value = 10;
+        return true;
+    };
+    list.combine(apply);
+    REQUIRE(served == 2);
+    REQUIRE(list.poll(push_slot) == request::done);
+    REQUIRE(list.value(push_slot) == 10);
+    REQUIRE(list.poll(extract_slot) == request::failed);
+    // Served requests stay untouched until their requester releases them
+    list.combine(apply);
+    REQUIRE(served == 2);
+    list.release(push_slot);
+    REQUIRE(list.post(request::push, 2, 2) == push_slot);
+}
+
+TEST_CASE("unlocking a queue serves the delegated requests", "[combining]") {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, CombiningSingleQueue>;
+    using access = multiqueue::test_access<multiqueue_t>;
+    using request = multiqueue::util::publication_list<typename multiqueue_t::value_type,
+                                                       CombiningSingleQueue::CombiningSlots>::request;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    auto &publications = access::publications(pq, 0);
+    typename multiqueue_t::value_type top;
+
+    SECTION("push and extract") {
+        pq.push(handle, {5, 5});
+        REQUIRE(access::try_lock(pq, handle, 0));
+        // Requests are served in the order of their slots, so the extraction sees the pushed element
+        auto const push_slot = publications.post(request::push, 0, {3, 3});
+        auto const extract_slot = publications.post(request::extract, 0, {0, 0});
+        REQUIRE(publications.poll(push_slot) == request::push);
+        access::unlock(pq, handle, 0);
+        REQUIRE(publications.poll(push_slot) == request::done);
+        REQUIRE(publications.poll(extract_slot) == request::done);
+        REQUIRE(publications.value(extract_slot) == std::pair<std::uint32_t, std::uint32_t>{3, 3});
+        publications.release(push_slot);
+        publications.release(extract_slot);
+        REQUIRE(pq.extract_top(handle, top));
+        REQUIRE(top.first == 5);
+        REQUIRE_FALSE(pq.extract_top(handle, top));
+    }
+
+    SECTION("extract from empty queue") {
+        REQUIRE(access::try_lock(pq, handle, 0));
+        auto const slot = publications.post(request::extract, 0, {0, 0});
+        access::unlock(pq, handle, 0);
+        REQUIRE(publications.poll(slot) == request::failed);
+        publications.release(slot);
+    }
+
+    SECTION("withdrawn request") {
+        pq.push(handle, {5, 5});
+        auto const slot = publications.post(request::extract, 0, {0, 0});
+        // The requester acquires the lock itself, so its request is still pending and can be withdrawn
+        REQUIRE(access::try_lock(pq, handle, 0));
+        REQUIRE(publications.poll(slot) == request::extract);
+        publications.release(slot);
+        access::unlock(pq, handle, 0);
+        REQUIRE(publications.poll(slot) == request::none);
+        REQUIRE(pq.extract_top(handle, top));
+        REQUIRE(top.first == 5);
+    }
+}
@@ -0,0 +1,136 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+struct DeletionCacheMerging : multiqueue::configuration::DeletionCache {
+    static constexpr bool UseMergeHeap = true;
+};
+
+// All elements are in one queue, so the cache holds consecutive keys
+struct DeletionCacheSingleQueue : multiqueue::configuration::DeletionCache {
+    static constexpr unsigned int C = 1;
+};
+
+TEST_CASE("deletion cache serves minima in order", "[deletion_cache]") {
+    using multiqueue_t =
+        multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, multiqueue::configuration::DeletionCache>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        pq.push(handle, {i, i});
+    }
+    typename multiqueue_t::value_type top;
+    std::vector<std::uint32_t> extracted;
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(handle, top)) {
+            extracted.push_back(top.first);
+        }
+    }
+    std::sort(extracted.begin(), extracted.end());
+    REQUIRE(extracted.size() == 100);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        REQUIRE(extracted[i] == i);
+    }
+    auto const stats = pq.get_deletion_cache_stats();
+    REQUIRE(stats.served + stats.refills == 100);
+    REQUIRE(stats.served > 0);
+}
+
+TEST_CASE("deletion cache is beaten by smaller keys", "[deletion_cache]") {
+    using multiqueue_t =
+        multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, multiqueue::configuration::DeletionCache>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 10; i < 20; ++i) {
+        pq.push(handle, {i, i});
+    }
+    typename multiqueue_t::value_type top;
+    // Retry until the queue with the elements was sampled
+    while (!pq.extract_top(handle, top)) {
+    }
+    // Push a smaller key into every queue, so any sample beats the cache
+    for (unsigned int i = 0; i < multiqueue::configuration::DeletionCache::C; ++i) {
+        pq.push(handle, {0, 0});
+    }
+    REQUIRE(pq.extract_top(handle, top));
+    REQUIRE(top.first == 0);
+    REQUIRE(pq.get_deletion_cache_stats().beaten == 1);
+}
+
+TEST_CASE("flush returns the cached elements", "[deletion_cache]") {
+    using multiqueue_t =
+        multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, multiqueue::configuration::DeletionCache>;
+    auto pq = multiqueue_t{2};
+    auto first = pq.get_handle(0);
+    auto second = pq.get_handle(1);
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        pq.push(first, {i, i});
+    }
+    typename multiqueue_t::value_type top;
+    while (!pq.extract_top(first, top)) {
+    }
+    auto distribution = pq.get_distribution();
+    REQUIRE(std::accumulate(distribution.begin(), distribution.end(), std::size_t{0}) == 999);
+    pq.flush(first);
+    REQUIRE(pq.get_deletion_cache_stats().returned == multiqueue::configuration::DeletionCache::DeletionCacheSize - 1);
+    distribution = pq.get_distribution();
+    REQUIRE(std::accumulate(distribution.begin(), distribution.end(), std::size_t{0}) == 999);
+    // Everything is reachable for the other handle now
+    std::size_t count = 0;
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(second, top)) {
+            ++count;
+        }
+    }
+    pq.flush(second);
+    for (unsigned int t = 0; t < 2; ++t) {
+        while (pq.extract_from_partition(pq.get_handle(t), top)) {
+            ++count;
+        }
+    }
+    REQUIRE(count == 999);
+}
+
+TEST_CASE("batch and partition extractions serve the cache first", "[deletion_cache]") {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, DeletionCacheSingleQueue>;
+    static constexpr std::size_t cache_size = DeletionCacheSingleQueue::DeletionCacheSize;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        pq.push(handle, {i, i});
+    }
+    typename multiqueue_t::value_type top;
+    while (!pq.extract_top(handle, top)) {
+    }
+    auto const cached = top.first;
+    std::vector<typename multiqueue_t::value_type> batch;
+    REQUIRE(pq.extract_batch(handle, std::back_inserter(batch), 2) == 2);
+    REQUIRE(batch[0].first == cached + 1);
+    REQUIRE(batch[1].first == cached + 2);
+    REQUIRE(pq.extract_from_partition(handle, top));
+    REQUIRE(top.first == cached + 3);
+    REQUIRE(pq.get_deletion_cache_stats().served == 3);
+    // The rest of the cache and then elements of the local queue
+    batch.clear();
+    REQUIRE(pq.extract_batch(handle, std::back_inserter(batch), cache_size) == cache_size);
+    for (std::size_t i = 0; i < cache_size; ++i) {
+        REQUIRE(batch[i].first == cached + 4 + i);
+    }
+}
+
+TEMPLATE_TEST_CASE("deletion cache keeps all elements", "[deletion_cache][workloads]",
+                   multiqueue::configuration::DeletionCache, DeletionCacheMerging) {
+    auto pq = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>{4};
+    // Elements left in the own cache are not reachable for other handles
+    workloads::require_all_extracted(workloads::push_extract_drain(pq, 4, 20'000, workloads::flush{}), 4 * 20'000);
+}
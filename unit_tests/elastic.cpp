@@ -0,0 +1,120 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>  // std::less
+#include <thread>
+#include <vector>
+
+TEST_CASE("elastic multiqueue hands out each handle once", "[elastic]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::NoBuffering>;
+    auto pq = multiqueue_t{multiqueue::elastic, 2};
+    auto first = pq.register_handle();
+    auto second = pq.register_handle();
+    REQUIRE(first.has_value());
+    REQUIRE(second.has_value());
+    REQUIRE_FALSE(pq.register_handle().has_value());
+    pq.release_handle(*first);
+    auto third = pq.register_handle();
+    REQUIRE(third.has_value());
+    REQUIRE_FALSE(pq.register_handle().has_value());
+}
+
+TEST_CASE("released handles keep their elements", "[elastic]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::NoBuffering>;
+    auto pq = multiqueue_t{multiqueue::elastic, 4};
+    std::vector<multiqueue_t::Handle> handles;
+    for (int i = 0; i < 4; ++i) {
+        handles.push_back(*pq.register_handle());
+    }
+    for (int i = 0; i < 1000; ++i) {
+        pq.push(handles[static_cast<std::size_t>(i % 4)], {i, i});
+    }
+    for (std::size_t i = 1; i < 4; ++i) {
+        pq.release_handle(handles[i]);
+    }
+    // All elements are now in the queues of the remaining handle
+    std::vector<int> extracted;
+    typename multiqueue_t::value_type top;
+    for (unsigned int misses = 0; misses < 1000; ++misses) {
+        while (pq.extract_top(handles[0], top)) {
+            extracted.push_back(top.second);
+        }
+    }
+    std::sort(extracted.begin(), extracted.end());
+    REQUIRE(extracted.size() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(extracted[static_cast<std::size_t>(i)] == i);
+    }
+    REQUIRE(pq.try_terminate(handles[0]));
+}
+
+TEST_CASE("partitions stay within the active queues", "[elastic]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::NoBuffering>;
+    auto pq = multiqueue_t{multiqueue::elastic, 3};
+    auto first = *pq.register_handle();
+    auto second = *pq.register_handle();
+    auto third = *pq.register_handle();
+    pq.release_handle(second);
+    // The queues of the partition with the highest id are retired, so the third handle moves to the second partition
+    for (int i = 0; i < 100; ++i) {
+        pq.push(third, {i, i});
+    }
+    std::vector<int> extracted;
+    typename multiqueue_t::value_type top;
+    while (pq.extract_from_partition(third, top)) {
+        extracted.push_back(top.second);
+    }
+    while (pq.extract_from_partition(first, top)) {
+        extracted.push_back(top.second);
+    }
+    std::sort(extracted.begin(), extracted.end());
+    REQUIRE(extracted.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(extracted[static_cast<std::size_t>(i)] == i);
+    }
+}
+
+TEMPLATE_TEST_CASE("elastic multiqueue keeps all elements while workers come and go", "[elastic][workloads]",
+                   multiqueue::configuration::NoBuffering, multiqueue::configuration::FullBuffering,
+                   multiqueue::configuration::AdaptiveStickiness) {
+    using multiqueue_t = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, TestType>;
+    static constexpr unsigned int max_threads = 4;
+    static constexpr unsigned int rounds = 20;
+    static constexpr std::uint32_t elements_per_round = 1'000;
+    auto pq = multiqueue_t{multiqueue::elastic, max_threads};
+
+    std::vector<std::vector<std::uint32_t>> extracted(max_threads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < max_threads; ++t) {
+        threads.emplace_back([&pq, &extracted, t]() {
+            typename multiqueue_t::value_type top;
+            for (unsigned int r = 0; r < rounds; ++r) {
+                auto handle = pq.register_handle();
+                if (!handle) {
+                    continue;
+                }
+                for (std::uint32_t i = 0; i < elements_per_round; ++i) {
+                    auto const value = (t * rounds + r) * elements_per_round + i;
+                    pq.push(*handle, {value, value});
+                    if (i % 2 == 1 && pq.extract_top(*handle, top)) {
+                        extracted[t].push_back(top.second);
+                    }
+                }
+                pq.release_handle(*handle);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    workloads::drain(pq, *pq.register_handle(), extracted[0]);
+    workloads::require_all_extracted(extracted, max_threads * rounds * elements_per_round);
+}
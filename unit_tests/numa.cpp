@@ -0,0 +1,99 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/numa.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>  // std::less
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("numa local ranges partition the queues", "[numa]") {
+    using multiqueue::util::numa_local_range;
+    REQUIRE(numa_local_range(8, 0, 2) == std::pair<std::size_t, std::size_t>{0, 4});
+    REQUIRE(numa_local_range(8, 1, 2) == std::pair<std::size_t, std::size_t>{4, 8});
+    // The last node gets the remaining queues
+    REQUIRE(numa_local_range(10, 2, 3) == std::pair<std::size_t, std::size_t>{6, 10});
+    // More nodes than queues
+    REQUIRE(numa_local_range(2, 0, 4) == std::pair<std::size_t, std::size_t>{0, 1});
+    REQUIRE(numa_local_range(2, 3, 4) == std::pair<std::size_t, std::size_t>{2, 2});
+    REQUIRE(numa_local_range(8, 0, 1) == std::pair<std::size_t, std::size_t>{0, 8});
+}
+
+TEST_CASE("parallel first touch visits every queue once", "[numa]") {
+    for (unsigned int num_workers : {1u, 3u, 64u}) {
+        std::size_t const num_queues = 37;
+        auto visits = std::make_unique<std::atomic_int[]>(num_queues);
+        multiqueue::util::parallel_first_touch(num_queues, num_workers,
+                                               [&visits](std::size_t i) { visits[i].fetch_add(1); });
+        for (std::size_t i = 0; i < num_queues; ++i) {
+            REQUIRE(visits[i].load() == 1);
+        }
+    }
+}
+
+TEST_CASE("parallel first touch rethrows exceptions", "[numa]") {
+    auto touch = [](std::size_t i) {
+        if (i == 5) {
+            throw std::runtime_error{"touch failed"};
+        }
+    };
+    REQUIRE_THROWS_AS(multiqueue::util::parallel_first_touch(8, 4, touch), std::runtime_error);
+}
+
+#ifdef MULTIQUEUE_HAVE_NUMA
+struct Interleaved : multiqueue::configuration::Default {
+    static constexpr bool NumaFriendly = true;
+};
+
+TEST_CASE("numa friendly constructors keep the memory policy of the calling thread", "[numa]") {
+    if (numa_available() < 0) {
+        return;
+    }
+    numa_set_preferred(0);
+    {
+        auto pq = multiqueue::multiqueue<int, int, std::less<int>, Interleaved>{2};
+        auto int_pq = multiqueue::int_multiqueue<unsigned int, int, Interleaved>{2};
+    }
+    int mode = MPOL_DEFAULT;
+    REQUIRE(get_mempolicy(&mode, nullptr, 0, nullptr, 0) == 0);
+    numa_set_localalloc();
+    REQUIRE(mode == MPOL_PREFERRED);
+}
+#endif
+
+struct LocalOnly : multiqueue::configuration::NoBuffering {
+    static constexpr double NumaRemoteProbability = 0.0;
+};
+
+TEST_CASE("handles bound to a node only sample local queues", "[numa]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, LocalOnly>;
+    auto pq = multiqueue_t{2};
+    auto first = pq.get_handle(0);
+    auto second = pq.get_handle(1);
+    pq.set_numa_node(first, 0, 2);
+    pq.set_numa_node(second, 1, 2);
+    for (int i = 0; i < 100; ++i) {
+        pq.push(first, {i, i});
+    }
+    // The second handle never sees the queues of the first node
+    typename multiqueue_t::value_type top;
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE_FALSE(pq.extract_top(second, top));
+    }
+    std::vector<int> extracted;
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(first, top)) {
+            extracted.push_back(top.second);
+        }
+    }
+    std::sort(extracted.begin(), extracted.end());
+    REQUIRE(extracted.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(extracted[static_cast<std::size_t>(i)] == i);
+    }
+}
@@ -0,0 +1,102 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/util/quality.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+template <unsigned int NumQueues>
+struct MeasureAll : multiqueue::configuration::Default {
+    static constexpr unsigned int C = NumQueues;
+    static constexpr double QualitySampleRate = 1.0;
+    static constexpr std::size_t ReservePerQueue = 1 << 10;
+};
+
+struct MeasureSome : MeasureAll<4> {
+    static constexpr double QualitySampleRate = 0.25;
+};
+
+}  // namespace
+
+TEST_CASE("log histogram buckets and quantiles", "[quality]") {
+    using multiqueue::util::log_histogram;
+    REQUIRE(log_histogram::bucket(0) == 0);
+    REQUIRE(log_histogram::bucket(1) == 1);
+    REQUIRE(log_histogram::bucket(7) == 3);
+    REQUIRE(log_histogram::bucket(8) == 4);
+    REQUIRE(log_histogram::bucket(~std::uint64_t{0}) == 64);
+
+    log_histogram h;
+    REQUIRE(h.quantile(0.5) == 0);
+    h.buckets[0] = 90;
+    h.buckets[4] = 10;
+    REQUIRE(h.total() == 100);
+    REQUIRE(h.quantile(0.5) == 0);
+    REQUIRE(h.quantile(0.95) == 15);
+    h += h;
+    REQUIRE(h.total() == 200);
+}
+
+TEST_CASE("a single queue has no rank error", "[quality]") {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, MeasureAll<1>>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        pq.push(handle, {(i * 37) % 100, i});
+    }
+    typename multiqueue_t::value_type top;
+    while (pq.extract_top(handle, top)) {
+    }
+    auto const histograms = pq.get_quality_histograms(handle);
+    REQUIRE(histograms.rank_error.total() == 100);
+    REQUIRE(histograms.rank_error.buckets[0] == 100);
+    REQUIRE(histograms.delay.total() == 100);
+}
+
+TEST_CASE("rank errors of relaxed extractions are measured", "[quality]") {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, MeasureAll<4>>;
+    auto pq = multiqueue_t{2};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        pq.push(handle, {i, i});
+    }
+    std::vector<typename multiqueue_t::value_type> batch;
+    pq.extract_batch(handle, std::back_inserter(batch), 10);
+    typename multiqueue_t::value_type top;
+    for (unsigned int misses = 0; misses < 1000;) {
+        if (pq.extract_top(handle, top)) {
+            misses = 0;
+        } else {
+            ++misses;
+        }
+    }
+    auto const histograms = pq.get_quality_histograms();
+    REQUIRE(histograms.rank_error.total() == 1000);
+    REQUIRE(histograms.rank_error.buckets[0] < 1000);
+}
+
+TEST_CASE("only a fraction of keys is measured", "[quality]") {
+    auto pq = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, MeasureSome>{4};
+    workloads::push_extract_drain(pq, 4, 10'000);
+    auto const measured = pq.get_quality_histograms().rank_error.total();
+    REQUIRE(measured > 4 * 10'000 / 8);
+    REQUIRE(measured < 4 * 10'000 / 2);
+}
+
+TEST_CASE("sample rates just below one sample almost all keys", "[quality]") {
+    multiqueue::util::quality_monitor<std::uint32_t> monitor{1, std::nextafter(1.0, 0.0)};
+    unsigned int sampled = 0;
+    for (std::uint32_t key = 0; key < 1000; ++key) {
+        if (monitor.sampled(key)) {
+            ++sampled;
+        }
+    }
+    REQUIRE(sampled == 1000);
+}
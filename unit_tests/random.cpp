@@ -0,0 +1,63 @@
+#include "multiqueue/util/random.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_CASE("reduce maps to the range", "[random]") {
+    using multiqueue::util::reduce;
+    REQUIRE(reduce(0, 10) == 0);
+    REQUIRE(reduce(UINT32_MAX, 10) == 9);
+    REQUIRE(reduce(UINT32_MAX / 2, 2) == 0);
+    REQUIRE(reduce(UINT32_MAX / 2 + 1, 2) == 1);
+    REQUIRE(reduce(12345, 1) == 0);
+}
+
+TEMPLATE_TEST_CASE("index sampler is roughly uniform", "[random]", multiqueue::util::splitmix64,
+                   multiqueue::util::wyrand, multiqueue::util::xoshiro256starstar, std::mt19937) {
+    static constexpr std::size_t num_indices = 16;
+    static constexpr int num_samples = 160'000;
+    multiqueue::util::index_sampler<TestType> sampler;
+    std::seed_seq seq{42};
+    sampler.seed(seq);
+    sampler.set_size(num_indices);
+    std::vector<int> histogram(num_indices, 0);
+    for (int i = 0; i < num_samples / 2; ++i) {
+        std::size_t first;
+        std::size_t second;
+        sampler(first, second);
+        REQUIRE(first < num_indices);
+        REQUIRE(second < num_indices);
+        ++histogram[first];
+        ++histogram[second];
+    }
+    for (auto count : histogram) {
+        // The expected count is 10'000 with a standard deviation of about 100
+        REQUIRE(count > 9'000);
+        REQUIRE(count < 11'000);
+    }
+}
+
+TEST_CASE("index sampler prefers the local range", "[random]") {
+    multiqueue::util::index_sampler<multiqueue::util::xoshiro256starstar> sampler;
+    std::seed_seq seq{1};
+    sampler.seed(seq);
+    sampler.set_size(8);
+    sampler.set_local_range(4, 6, 0.0);
+    for (int i = 0; i < 1000; ++i) {
+        auto const index = sampler();
+        REQUIRE(index >= 4);
+        REQUIRE(index < 6);
+    }
+    sampler.set_local_range(4, 6, 1.0);
+    std::vector<int> histogram(8, 0);
+    for (int i = 0; i < 8000; ++i) {
+        ++histogram[sampler()];
+    }
+    REQUIRE(histogram[0] > 0);
+    REQUIRE(histogram[7] > 0);
+}
@@ -0,0 +1,85 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>  // std::greater
+#include <numeric>
+#include <vector>
+
+struct NoReservation : multiqueue::configuration::Default {
+    static constexpr std::size_t ReservePerQueue = 0;
+};
+
+struct SingleQueue : NoReservation {
+    static constexpr unsigned int C = 1;
+};
+
+struct NoReservationMerging : NoReservation {
+    static constexpr bool UseMergeHeap = true;
+    static constexpr std::size_t NodeSize = 8;
+};
+
+template <typename MultiQueue, typename Key>
+std::vector<Key> drain(MultiQueue &pq) {
+    auto handle = pq.get_handle(0);
+    std::vector<Key> keys;
+    typename MultiQueue::value_type top;
+    // An extraction can fail while other queues are not empty
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(handle, top)) {
+            keys.push_back(top.first);
+        }
+    }
+    return keys;
+}
+
+TEMPLATE_TEST_CASE("queues grow beyond the hinted size", "[reserve]", NoReservation, NoReservationMerging,
+                   multiqueue::configuration::Default) {
+    static constexpr std::uint32_t n = 10'000;
+    std::vector<std::uint32_t> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+
+    SECTION("int_multiqueue") {
+        auto pq = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>{2};
+        pq.reserve(n / 4);
+        auto handle = pq.get_handle(0);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            pq.push(handle, {i, i});
+        }
+        auto keys = drain<decltype(pq), std::uint32_t>(pq);
+        std::sort(keys.begin(), keys.end());
+        REQUIRE(keys == expected);
+    }
+
+    SECTION("multiqueue") {
+        auto pq = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, TestType>{2};
+        pq.reserve(n / 4);
+        auto handle = pq.get_handle(0);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            pq.push(handle, {i, i});
+        }
+        auto keys = drain<decltype(pq), std::uint32_t>(pq);
+        std::sort(keys.begin(), keys.end());
+        REQUIRE(keys == expected);
+    }
+}
+
+TEST_CASE("multiqueue constructed with a comparator uses it", "[reserve]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::greater<int>, SingleQueue>;
+    auto pq = multiqueue_t{1, std::greater<int>{}};
+    pq.reserve(100);
+    auto handle = pq.get_handle(0);
+    for (int i = 0; i < 100; ++i) {
+        pq.push(handle, {i, i});
+    }
+    // With a single local queue, the elements are extracted in order
+    auto keys = drain<multiqueue_t, int>(pq);
+    std::vector<int> expected(100);
+    std::iota(expected.rbegin(), expected.rend(), 0);
+    REQUIRE(keys == expected);
+}
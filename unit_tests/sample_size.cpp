@@ -0,0 +1,73 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+template <unsigned int ExtractD, unsigned int InsertD>
+struct Sampling : multiqueue::configuration::Default {
+    static constexpr unsigned int ExtractSampleSize = ExtractD;
+    static constexpr unsigned int InsertSampleSize = InsertD;
+    static constexpr std::size_t ReservePerQueue = 1 << 10;
+};
+
+template <unsigned int ExtractD, unsigned int InsertD>
+struct StickySampling : Sampling<ExtractD, InsertD> {
+    static constexpr unsigned int K = 4;
+};
+
+template <unsigned int ExtractD>
+struct LockedSampling : Sampling<ExtractD, 4> {
+    static constexpr bool WithTopSnapshot = false;
+};
+
+// Sum over all extractions of the number of smaller keys still contained
+template <typename MultiQueue>
+std::uint64_t sequential_rank_error(unsigned int num_threads) {
+    static constexpr std::uint32_t num_elements = 1000;
+    auto pq = MultiQueue{num_threads};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < num_elements; ++i) {
+        pq.push(handle, {(i * 7919) % num_elements, 0});
+    }
+    std::vector<bool> contained(num_elements, true);
+    typename MultiQueue::value_type top;
+    std::uint64_t error = 0;
+    for (std::uint32_t i = 0; i < num_elements;) {
+        if (!pq.extract_top(handle, top)) {
+            continue;
+        }
+        error += static_cast<std::uint64_t>(std::count(contained.begin(), contained.begin() + top.first, true));
+        contained[top.first] = false;
+        ++i;
+    }
+    return error;
+}
+
+TEST_CASE("sampling more queues lowers the rank error", "[sample_size]") {
+    auto const int_error_2 =
+        sequential_rank_error<multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Sampling<2, 1>>>(4);
+    auto const int_error_8 =
+        sequential_rank_error<multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Sampling<8, 1>>>(4);
+    REQUIRE(int_error_8 < int_error_2);
+    auto const error_2 = sequential_rank_error<
+        multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, Sampling<2, 1>>>(4);
+    auto const error_8 = sequential_rank_error<
+        multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, Sampling<8, 1>>>(4);
+    REQUIRE(error_8 < error_2);
+}
+
+TEMPLATE_TEST_CASE("sampled queues keep all elements", "[sample_size][workloads]", (Sampling<1, 1>),
+                   (Sampling<3, 2>), (Sampling<8, 4>), (StickySampling<4, 3>), (LockedSampling<8>)) {
+    auto int_pq = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>{4};
+    workloads::require_all_extracted(workloads::push_extract_drain(int_pq, 4, 10'000), 4 * 10'000);
+    auto pq = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, TestType>{4};
+    workloads::require_all_extracted(workloads::push_extract_drain(pq, 4, 10'000), 4 * 10'000);
+}
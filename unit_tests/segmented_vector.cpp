@@ -0,0 +1,168 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/sequential/heap/heap.hpp"
+#include "multiqueue/sequential/heap/merge_heap.hpp"
+#include "multiqueue/util/segmented_vector.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <vector>
+
+// Small blocks and no preallocation, so that the heaps grow block by block
+struct SmallBlocks : multiqueue::configuration::Segmented {
+    static constexpr std::size_t HeapBlockSize = 16;
+    static constexpr std::size_t ReservePerQueue = 0;
+};
+
+struct SmallBlocksNoBuffering : SmallBlocks {
+    static constexpr bool WithDeletionBuffer = false;
+    static constexpr bool WithInsertionBuffer = false;
+};
+
+struct SmallBlocksMerging : SmallBlocks {
+    static constexpr bool UseMergeHeap = true;
+    static constexpr std::size_t NodeSize = 8;
+};
+
+TEST_CASE("segmented_vector keeps elements in place when growing", "[segmented_vector]") {
+    multiqueue::util::segmented_vector<int, 4> v;
+    REQUIRE(v.empty());
+    v.push_back(0);
+    int const *first = &v[0];
+    for (int i = 1; i < 100; ++i) {
+        v.push_back(i);
+    }
+    REQUIRE(&v[0] == first);
+    REQUIRE(v.size() == 100);
+    REQUIRE(v.capacity() == 100);
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    REQUIRE(v.front() == 0);
+    REQUIRE(v.back() == 99);
+
+    v.resize(10);
+    REQUIRE(v.size() == 10);
+    REQUIRE(v.back() == 9);
+    // Removing elements keeps the blocks
+    REQUIRE(v.capacity() == 100);
+    v.resize(12);
+    REQUIRE(v[11] == 0);
+
+    auto copy = v;
+    auto moved = std::move(v);
+    REQUIRE(copy.size() == 12);
+    REQUIRE(moved.size() == 12);
+    REQUIRE(std::equal(copy.begin(), copy.end(), moved.begin()));
+    moved.clear();
+    REQUIRE(moved.empty());
+}
+
+TEST_CASE("segmented_vector reserve allocates whole blocks", "[segmented_vector]") {
+    multiqueue::util::segmented_vector<std::uint64_t, 8> v;
+    v.reserve(9);
+    REQUIRE(v.capacity() == 16);
+    REQUIRE(v.empty());
+    v.reserve(3);
+    REQUIRE(v.capacity() == 16);
+}
+
+TEST_CASE("heap with blocked storage", "[segmented_vector][heap]") {
+    multiqueue::sequential::value_heap<std::uint32_t, std::less<std::uint32_t>, 4,
+                                       multiqueue::sequential::sift_strategy::FullDown, std::allocator<std::uint32_t>,
+                                       8>
+        heap;
+    std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<std::uint32_t>> reference;
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<std::uint32_t> dist{0, 1000};
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            auto const key = dist(gen);
+            heap.insert(key);
+            reference.push(key);
+        }
+        for (int i = 0; i < 500; ++i) {
+            REQUIRE(heap.top() == reference.top());
+            heap.pop();
+            reference.pop();
+        }
+    }
+    while (!reference.empty()) {
+        REQUIRE(heap.top() == reference.top());
+        heap.pop();
+        reference.pop();
+    }
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("merge_heap with blocked storage", "[segmented_vector][merge_heap]") {
+    multiqueue::sequential::value_merge_heap<std::uint32_t, std::less<std::uint32_t>, 8, std::allocator<std::uint32_t>,
+                                             4>
+        heap;
+    std::array<std::uint32_t, 8> input;
+    for (std::uint32_t i = 1000; i > 0; --i) {
+        std::iota(input.begin(), input.end(), (i - 1) * 8);
+        heap.insert(input.begin(), input.end());
+    }
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        std::iota(input.begin(), input.end(), i * 8);
+        REQUIRE(std::equal(heap.top_node().begin(), heap.top_node().end(), input.begin()));
+        heap.pop_node();
+    }
+    REQUIRE(heap.empty());
+}
+
+TEMPLATE_TEST_CASE("int_multiqueue with blocked heaps returns all elements", "[segmented_vector]", SmallBlocks,
+                   SmallBlocksNoBuffering, SmallBlocksMerging) {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    static constexpr std::uint32_t n = 10'000;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        pq.push(handle, {(i * 7919) % n, i});
+    }
+    std::vector<std::uint32_t> keys;
+    typename multiqueue_t::value_type top;
+    // An extraction can fail while other queues are not empty
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(handle, top)) {
+            keys.push_back(top.first);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<std::uint32_t> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(keys == expected);
+}
+
+TEMPLATE_TEST_CASE("multiqueue with blocked heaps returns all elements", "[segmented_vector]", SmallBlocks,
+                   SmallBlocksNoBuffering, SmallBlocksMerging) {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, TestType>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    static constexpr int n = 10'000;
+    for (int i = 0; i < n; ++i) {
+        pq.push(handle, {(i * 7919) % n, i});
+    }
+    std::vector<int> keys;
+    typename multiqueue_t::value_type top;
+    // An extraction can fail while other queues are not empty
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(handle, top)) {
+            keys.push_back(top.first);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<int> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(keys == expected);
+}
@@ -0,0 +1,69 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/seqlock.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+struct Triple {
+    std::uint64_t a;
+    std::uint64_t b;
+    std::uint32_t c;
+};
+
+TEST_CASE("seqlock loads the last stored value", "[seqlock]") {
+    multiqueue::util::seqlock<Triple> lock;
+    auto value = lock.load();
+    REQUIRE(value.a == 0);
+    REQUIRE(value.b == 0);
+    REQUIRE(value.c == 0);
+    lock.store({1, 2, 3});
+    value = lock.load();
+    REQUIRE(value.a == 1);
+    REQUIRE(value.b == 2);
+    REQUIRE(value.c == 3);
+}
+
+TEST_CASE("seqlock never returns torn values", "[seqlock]") {
+    static constexpr std::uint64_t num_stores = 200'000;
+    multiqueue::util::seqlock<Triple> lock;
+    std::atomic_bool done{false};
+    std::atomic_uint64_t torn{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&lock, &done, &torn]() noexcept {
+            while (!done.load(std::memory_order_relaxed)) {
+                auto const value = lock.load();
+                if (value.b != 2 * value.a || value.c != static_cast<std::uint32_t>(value.a)) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (std::uint64_t i = 1; i <= num_stores; ++i) {
+        lock.store({i, 2 * i, static_cast<std::uint32_t>(i)});
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    REQUIRE(torn == 0);
+}
+
+struct WithoutTopSnapshot : multiqueue::configuration::NoBuffering {
+    static constexpr bool WithTopSnapshot = false;
+};
+
+TEMPLATE_TEST_CASE("multiqueue with top key snapshots keeps all elements", "[seqlock][workloads]",
+                   multiqueue::configuration::NoBuffering, multiqueue::configuration::FullBuffering,
+                   multiqueue::configuration::Merging, WithoutTopSnapshot) {
+    auto pq = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, TestType>{4};
+    workloads::require_all_extracted(workloads::push_extract_drain(pq, 4, 20'000), 4 * 20'000);
+}
@@ -0,0 +1,66 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>  // std::less
+#include <vector>
+
+struct StagingSticky : multiqueue::configuration::Staging {
+    static constexpr unsigned int K = 4;
+};
+
+struct StagingNoBuffering : multiqueue::configuration::NoBuffering {
+    static constexpr std::size_t StagingBufferSize = 4;
+};
+
+TEST_CASE("staged elements are extracted by their own handle", "[staging]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::Staging>;
+    auto pq = multiqueue_t{2};
+    auto first = pq.get_handle(0);
+    auto second = pq.get_handle(1);
+    pq.push(first, {3, 3});
+    pq.push(first, {1, 1});
+    pq.push(first, {2, 2});
+    typename multiqueue_t::value_type top;
+    // Not yet visible to other handles
+    REQUIRE_FALSE(pq.extract_top(second, top));
+    REQUIRE(pq.extract_top(first, top));
+    REQUIRE(top.first == 1);
+    // The remaining elements were moved into a local queue together with the minimum
+    std::vector<int> extracted;
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(second, top)) {
+            extracted.push_back(top.first);
+        }
+    }
+    std::sort(extracted.begin(), extracted.end());
+    REQUIRE(extracted == std::vector<int>{2, 3});
+}
+
+TEST_CASE("flush makes staged elements visible", "[staging]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::Staging>;
+    auto pq = multiqueue_t{2};
+    auto first = pq.get_handle(0);
+    auto second = pq.get_handle(1);
+    pq.push(first, {1, 1});
+    pq.flush(first);
+    typename multiqueue_t::value_type top;
+    bool found = false;
+    for (unsigned int i = 0; i < 100 && !found; ++i) {
+        found = pq.extract_top(second, top);
+    }
+    REQUIRE(found);
+    REQUIRE(top.first == 1);
+}
+
+TEMPLATE_TEST_CASE("staging keeps all elements", "[staging][workloads]", multiqueue::configuration::Staging,
+                   StagingSticky, StagingNoBuffering) {
+    auto pq = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, TestType>{4};
+    workloads::require_all_extracted(workloads::push_extract_drain(pq, 4, 20'000, workloads::flush{}), 4 * 20'000);
+}
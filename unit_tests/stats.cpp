@@ -0,0 +1,130 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/util/stats.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "workloads.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct Counting : multiqueue::configuration::Default {
+    static constexpr bool CollectStats = true;
+    static constexpr std::size_t ReservePerQueue = 1 << 10;
+};
+
+struct CountingUnbuffered : Counting {
+    static constexpr bool WithDeletionBuffer = false;
+    static constexpr bool WithInsertionBuffer = false;
+};
+
+struct CountingMerging : Counting {
+    static constexpr bool UseMergeHeap = true;
+};
+
+struct CountingSticky : Counting {
+    static constexpr unsigned int K = 4;
+};
+
+struct CountingSingleQueue : Counting {
+    static constexpr unsigned int C = 1;
+};
+
+using multiqueue::util::counter;
+
+}  // namespace
+
+TEST_CASE("heap levels", "[stats]") {
+    using multiqueue::util::heap_levels;
+    REQUIRE(heap_levels<2>(0) == 0);
+    REQUIRE(heap_levels<2>(1) == 0);
+    REQUIRE(heap_levels<2>(3) == 1);
+    REQUIRE(heap_levels<2>(4) == 2);
+    REQUIRE(heap_levels<8>(9) == 1);
+    REQUIRE(heap_levels<8>(10) == 2);
+}
+
+TEMPLATE_TEST_CASE("operations are counted", "[stats]", Counting, CountingUnbuffered, CountingMerging,
+                   CountingSticky) {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, TestType>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        pq.push(handle, {i, i});
+    }
+    std::vector<typename multiqueue_t::value_type> batch(10);
+    pq.push_batch(handle, batch.begin(), batch.end());
+    typename multiqueue_t::value_type top;
+    std::uint64_t extracted = 0;
+    std::uint64_t misses = 0;
+    while (misses < 100) {
+        if (pq.extract_top(handle, top)) {
+            ++extracted;
+        } else {
+            ++misses;
+        }
+    }
+    auto const stats = pq.stats();
+    REQUIRE(stats[counter::pushes] == 1010);
+    REQUIRE(stats[counter::extractions] == 1010);
+    REQUIRE(extracted == 1010);
+    REQUIRE(stats[counter::empty_extractions] == misses);
+    // A single handle never finds a queue locked
+    REQUIRE(stats[counter::lock_failures] == 0);
+    REQUIRE(stats[counter::retries] == 0);
+    REQUIRE(stats.retries_per_operation() == 0.0);
+    if constexpr (TestType::UseMergeHeap) {
+        REQUIRE(stats[counter::merge_node_pops] > 0);
+        REQUIRE(stats[counter::heap_pops] == 0);
+    } else {
+        REQUIRE(stats[counter::heap_pops] > 0);
+        REQUIRE(stats[counter::sift_levels] > 0);
+    }
+    if constexpr (TestType::WithDeletionBuffer) {
+        REQUIRE(stats[counter::deletion_buffer_refills] > 0);
+        REQUIRE(stats[counter::insertion_buffer_flushes] > 0);
+    } else {
+        REQUIRE(stats[counter::heap_pops] == 1010);
+        REQUIRE(stats[counter::deletion_buffer_refills] == 0);
+    }
+    REQUIRE(pq.stats(handle)[counter::pushes] == 1010);
+}
+
+TEST_CASE("only nonempty insertion buffers count as flushed", "[stats]") {
+    using multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, CountingSingleQueue>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    // The smallest key fills the deletion buffer, the others exactly fill the insertion buffer
+    for (std::uint32_t i = 0; i <= CountingSingleQueue::InsertionBufferSize; ++i) {
+        pq.push(handle, {i, i});
+    }
+    typename multiqueue_t::value_type top;
+    for (std::uint32_t i = 0; i <= CountingSingleQueue::InsertionBufferSize; ++i) {
+        REQUIRE(pq.extract_top(handle, top));
+        REQUIRE(top.first == i);
+    }
+    auto const stats = pq.stats();
+    // The first refill moves the insertion buffer into the deletion buffer, the second finds nothing to flush
+    REQUIRE(stats[counter::deletion_buffer_refills] == 2);
+    REQUIRE(stats[counter::insertion_buffer_flushes] == 1);
+}
+
+TEST_CASE("counters of concurrent handles add up", "[stats][workloads]") {
+    static constexpr unsigned int num_threads = 4;
+    static constexpr std::uint32_t elements_per_thread = 20'000;
+    auto pq = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Counting>{num_threads};
+    auto const extracted = workloads::push_extract_drain(pq, num_threads, elements_per_thread);
+    multiqueue::util::operation_stats sum;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        auto const stats = pq.stats(pq.get_handle(t));
+        REQUIRE(stats[counter::pushes] == elements_per_thread);
+        REQUIRE(stats[counter::extractions] == extracted[t].size());
+        sum += stats;
+    }
+    REQUIRE(sum[counter::extractions] == num_threads * elements_per_thread);
+    REQUIRE(pq.stats()[counter::lock_failures] == sum[counter::lock_failures]);
+}
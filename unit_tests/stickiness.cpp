@@ -0,0 +1,134 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/int_multiqueue.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>  // std::less
+#include <thread>
+#include <vector>
+
+struct Adaptive : multiqueue::configuration::AdaptiveStickiness {
+    static constexpr unsigned int MinK = 2;
+    static constexpr unsigned int MaxK = 16;
+};
+
+// Two handles on two queues, so that the pheromones of one handle make the other lose its sticky queue
+struct AdaptivePheromones : Adaptive {
+    static constexpr unsigned int C = 1;
+    static constexpr bool WithPheromones = true;
+};
+
+using int_multiqueue_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, Adaptive>;
+using multiqueue_t = multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, Adaptive>;
+using int_multiqueue_pheromones_t = multiqueue::int_multiqueue<std::uint32_t, std::uint32_t, AdaptivePheromones>;
+using multiqueue_pheromones_t =
+    multiqueue::multiqueue<std::uint32_t, std::uint32_t, std::less<std::uint32_t>, AdaptivePheromones>;
+
+TEMPLATE_TEST_CASE("stickiness grows after full periods", "[stickiness]", int_multiqueue_t, multiqueue_t) {
+    auto pq = TestType{1};
+    auto handle = pq.get_handle(0);
+    REQUIRE(pq.stickiness(handle) == Adaptive::K);
+    // Without contention, every period of pushes ends on the sticky queue
+    for (unsigned int k = Adaptive::K; k < Adaptive::MaxK; k *= 2) {
+        for (unsigned int i = 0; i < k; ++i) {
+            REQUIRE(pq.stickiness(handle) == k);
+            pq.push(handle, {i, i});
+        }
+        REQUIRE(pq.stickiness(handle) == 2 * k);
+    }
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        pq.push(handle, {i, i});
+    }
+    REQUIRE(pq.stickiness(handle) == Adaptive::MaxK);
+}
+
+TEMPLATE_TEST_CASE("stickiness shrinks on empty sticky queues", "[stickiness]", int_multiqueue_t, multiqueue_t) {
+    auto pq = TestType{1};
+    auto handle = pq.get_handle(0);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        pq.push(handle, {i, i});
+    }
+    REQUIRE(pq.stickiness(handle) == Adaptive::MaxK);
+    typename TestType::value_type top;
+    for (unsigned int misses = 0; misses < 100; ++misses) {
+        while (pq.extract_top(handle, top)) {
+        }
+    }
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE_FALSE(pq.extract_top(handle, top));
+    }
+    REQUIRE(pq.stickiness(handle) == Adaptive::MinK);
+}
+
+TEMPLATE_TEST_CASE("stickiness changes at most once per period", "[stickiness]", int_multiqueue_t, multiqueue_t) {
+    auto pq = TestType{1};
+    auto handle = pq.get_handle(0);
+    typename TestType::value_type top;
+    // Every extraction finds both sticky queues empty, but only the end of the period halves the stickiness
+    for (unsigned int i = 1; i < Adaptive::K; ++i) {
+        REQUIRE_FALSE(pq.extract_top(handle, top));
+        REQUIRE(pq.stickiness(handle) == Adaptive::K);
+    }
+    REQUIRE_FALSE(pq.extract_top(handle, top));
+    REQUIRE(pq.stickiness(handle) == Adaptive::K / 2);
+}
+
+TEMPLATE_TEST_CASE("stickiness shrinks after lock failures", "[stickiness]", int_multiqueue_pheromones_t,
+                   multiqueue_pheromones_t) {
+    auto pq = TestType{2};
+    auto first = pq.get_handle(0);
+    auto second = pq.get_handle(1);
+    bool shrunk = false;
+    // Pushes only shrink the stickiness if the sticky queue could not be locked, which happens once the other handle
+    // left its pheromone on it
+    for (std::uint32_t i = 0; i < 1000 && !shrunk; ++i) {
+        auto const k = pq.stickiness(first);
+        pq.push(first, {i, i});
+        shrunk = pq.stickiness(first) < k;
+        pq.push(second, {i, i});
+    }
+    REQUIRE(shrunk);
+    REQUIRE(pq.stickiness(first) >= AdaptivePheromones::MinK);
+}
+
+TEMPLATE_TEST_CASE("stickiness stays within its bounds", "[stickiness]", int_multiqueue_t, multiqueue_t) {
+    static constexpr unsigned int num_threads = 4;
+    static constexpr std::uint32_t elements_per_thread = 10'000;
+    auto pq = TestType{num_threads};
+    std::atomic_bool out_of_bounds{false};
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&pq, &out_of_bounds, t]() {
+            auto handle = pq.get_handle(t);
+            auto check = [&]() {
+                auto const k = pq.stickiness(handle);
+                if (k < Adaptive::MinK || k > Adaptive::MaxK) {
+                    out_of_bounds = true;
+                }
+            };
+            typename TestType::value_type top;
+            for (std::uint32_t i = 0; i < elements_per_thread; ++i) {
+                pq.push(handle, {i, i});
+                check();
+                if (i % 2 == 1) {
+                    pq.extract_top(handle, top);
+                    check();
+                }
+            }
+            for (unsigned int misses = 0; misses < 100; ++misses) {
+                while (pq.extract_top(handle, top)) {
+                    check();
+                }
+                check();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE_FALSE(out_of_bounds);
+}
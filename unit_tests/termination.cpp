@@ -0,0 +1,58 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <functional>  // std::less
+#include <thread>
+#include <vector>
+
+TEST_CASE("try_terminate single thread", "[termination]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::NoBuffering>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    pq.push(handle, {1, 1});
+    REQUIRE_FALSE(pq.try_terminate(handle));
+    typename multiqueue_t::value_type top;
+    REQUIRE(pq.extract_from_partition(handle, top));
+    REQUIRE(pq.try_terminate(handle));
+    REQUIRE(pq.try_terminate(handle));
+}
+
+TEMPLATE_TEST_CASE("try_terminate after tree workload", "[termination][workloads]",
+                   multiqueue::configuration::NoBuffering, multiqueue::configuration::FullBuffering,
+                   multiqueue::configuration::Merging, multiqueue::configuration::AdaptiveStickiness,
+                   multiqueue::configuration::Staging) {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, TestType>;
+    static constexpr unsigned int num_threads = 4;
+    // Every element with key k < max_depth spawns two children with key k + 1
+    static constexpr int max_depth = 12;
+    auto pq = multiqueue_t{num_threads};
+    pq.push(pq.get_handle(0), {0, 0});
+
+    std::atomic_int processed{0};
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&pq, &processed, t]() {
+            auto handle = pq.get_handle(t);
+            typename multiqueue_t::value_type top;
+            while (true) {
+                if (pq.extract_top(handle, top)) {
+                    processed.fetch_add(1, std::memory_order_relaxed);
+                    if (top.first < max_depth) {
+                        pq.push(handle, {top.first + 1, 0});
+                        pq.push(handle, {top.first + 1, 0});
+                    }
+                } else if (pq.try_terminate(handle)) {
+                    break;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(processed.load() == (1 << (max_depth + 1)) - 1);
+}
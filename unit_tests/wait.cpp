@@ -0,0 +1,79 @@
+#include "multiqueue/configurations.hpp"
+#include "multiqueue/multiqueue.hpp"
+#include "multiqueue/util/parking.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>  // std::less
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+#ifdef __linux__
+// Without futexes, parking only sleeps for the timeout
+TEST_CASE("notify wakes a parked thread", "[wait]") {
+    // The slice is long enough that only the notification can end the park in time
+    multiqueue::util::parking parking{60s};
+    std::atomic_bool prepared{false};
+    std::thread sleeper([&]() {
+        auto const epoch = parking.prepare_park();
+        prepared.store(true, std::memory_order_release);
+        parking.park(epoch, 60s);
+    });
+    while (!prepared.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    // Give the sleeper time to enter the futex, a notification before that makes it return immediately
+    std::this_thread::sleep_for(20ms);
+    auto const start = std::chrono::steady_clock::now();
+    parking.notify();
+    sleeper.join();
+    REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+}
+#endif
+
+TEST_CASE("extract_top_wait times out on empty queue", "[wait]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::NoBuffering>;
+    auto pq = multiqueue_t{1};
+    auto handle = pq.get_handle(0);
+    typename multiqueue_t::value_type top;
+    auto const start = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(pq.extract_top_wait(handle, top, 20ms));
+    REQUIRE(std::chrono::steady_clock::now() - start >= 20ms);
+}
+
+TEST_CASE("extract_top_wait gets woken by push", "[wait][workloads]") {
+    using multiqueue_t = multiqueue::multiqueue<int, int, std::less<int>, multiqueue::configuration::NoBuffering>;
+    static constexpr int num_consumers = 3;
+    static constexpr int elements_per_consumer = 100;
+    auto pq = multiqueue_t{num_consumers + 1};
+
+    std::atomic_int extracted{0};
+    std::vector<std::thread> consumers;
+    for (unsigned int t = 0; t < num_consumers; ++t) {
+        consumers.emplace_back([&pq, &extracted, t]() {
+            auto handle = pq.get_handle(t);
+            typename multiqueue_t::value_type top;
+            for (int i = 0; i < elements_per_consumer; ++i) {
+                if (pq.extract_top_wait(handle, top, 10s)) {
+                    extracted.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    auto handle = pq.get_handle(num_consumers);
+    for (int i = 0; i < num_consumers * elements_per_consumer; ++i) {
+        if (i % 50 == 0) {
+            // Give the consumers time to park
+            std::this_thread::sleep_for(5ms);
+        }
+        pq.push(handle, {i, i});
+    }
+    for (auto &consumer : consumers) {
+        consumer.join();
+    }
+    REQUIRE(extracted.load() == num_consumers * elements_per_consumer);
+}
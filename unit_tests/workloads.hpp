@@ -0,0 +1,87 @@
+#ifndef TESTS_UNIT_TESTS_WORKLOADS_HPP_INCLUDED
+#define TESTS_UNIT_TESTS_WORKLOADS_HPP_INCLUDED
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace workloads {
+
+// Called by every thread after its last operation
+struct no_finish {
+    template <typename MultiQueue, typename Handle>
+    void operator()(MultiQueue & /*pq*/, Handle /*handle*/) const noexcept {
+    }
+};
+
+// Makes elements buffered by the handle reachable for the other handles
+struct flush {
+    template <typename MultiQueue, typename Handle>
+    void operator()(MultiQueue &pq, Handle handle) const {
+        pq.flush(handle);
+    }
+};
+
+// Extracts with `handle` until extraction failed 1000 times in a row, as sampling may miss nonempty queues
+template <typename MultiQueue, typename Handle>
+void drain(MultiQueue &pq, Handle handle, std::vector<std::uint32_t> &extracted) {
+    typename MultiQueue::value_type top;
+    for (unsigned int misses = 0; misses < 1000;) {
+        if (pq.extract_top(handle, top)) {
+            extracted.push_back(top.second);
+            misses = 0;
+        } else {
+            ++misses;
+        }
+    }
+}
+
+// Every handle pushes `elements_per_thread` distinct values and tries to extract after every second push. Then
+// `finish` is called for every handle, and the remaining elements are drained by the first handle. Returns the values
+// extracted by each handle.
+template <typename MultiQueue, typename Finish = no_finish>
+std::vector<std::vector<std::uint32_t>> push_extract_drain(MultiQueue &pq, unsigned int num_threads,
+                                                           std::uint32_t elements_per_thread, Finish finish = {}) {
+    std::vector<std::vector<std::uint32_t>> extracted(num_threads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&pq, &extracted, &finish, elements_per_thread, t]() {
+            auto handle = pq.get_handle(t);
+            typename MultiQueue::value_type top;
+            for (std::uint32_t i = 0; i < elements_per_thread; ++i) {
+                auto const value = t * elements_per_thread + i;
+                pq.push(handle, {value, value});
+                if (i % 2 == 1 && pq.extract_top(handle, top)) {
+                    extracted[t].push_back(top.second);
+                }
+            }
+            finish(pq, handle);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    drain(pq, pq.get_handle(0), extracted[0]);
+    return extracted;
+}
+
+// Requires that the values 0 to `n` - 1 were extracted exactly once
+inline void require_all_extracted(std::vector<std::vector<std::uint32_t>> const &extracted, std::size_t n) {
+    std::vector<std::uint32_t> all;
+    for (auto const &e : extracted) {
+        all.insert(all.end(), e.begin(), e.end());
+    }
+    std::sort(all.begin(), all.end());
+    REQUIRE(all.size() == n);
+    for (std::uint32_t i = 0; i < all.size(); ++i) {
+        REQUIRE(all[i] == i);
+    }
+}
+
+}  // namespace workloads
+
+#endif  //! TESTS_UNIT_TESTS_WORKLOADS_HPP_INCLUDED